@@ -9,12 +9,18 @@
 //--------------------------------------------------------------------------------
 # include "non_pod_utils.h"
 # include "utils/queue_wrap.h"
+# include "utils/event_count.h"
 //--------------------------------------------------------------------------------
 namespace concur {
 //--------------------------------------------------------------------------------
 // simple concurrent containers with mutex and conditional variable
+//
+// Consumers waiting in 'pop' are counted under the mutex, so a producer
+// notifies only if someone is parked, and does it after unlocking: the woken
+// consumer doesn't run into the mutex still held. 'push_bulk' pushes a range
+// with one lock and wakes as many consumers as it has pushed elements.
 
-template < typename Type, bool Limited = false >
+template < typename Type, bool Limited = false, typename StorageType = std::queue< Type > >
 class CondvarQueue
 { 
 public:
@@ -33,12 +39,32 @@ public:
   template < typename T >
   bool push( T&& val )
   {
-    lock_type lock( mtx_ );
-    if( queue_.push( std::forward< T >( val ) ) ) {
-      condvar_.notify_one( );
-      return true;
+    unsigned waiters = 0;
+    {
+      lock_type lock( mtx_ );
+      if( !queue_.push( std::forward< T >( val ) ) )
+        return false;
+      waiters = waiters_;
     }
-    return false;
+    utils::notify_waiters( condvar_, 1, waiters );
+    return true;
+  }
+  
+  // pushes till the limit, returns the first element left out
+  template < typename InputIt >
+  InputIt push_bulk( InputIt first, InputIt last )
+  {
+    std::size_t pushed  = 0;
+    unsigned    waiters = 0;
+    {
+      lock_type lock( mtx_ );
+      const std::size_t size = queue_.size( );
+      first   = queue_.push_range( first, last );
+      pushed  = queue_.size( ) - size;
+      waiters = waiters_;
+    }
+    utils::notify_waiters( condvar_, pushed, waiters );
+    return first;
   }
   
   template < typename T >
@@ -53,7 +79,10 @@ public:
   {
     lock_type lock( mtx_ );
     while( !queue_.pop( dst ) ) {
-      if( condvar_.wait_for( lock, dur ) == std::cv_status::timeout )
+      ++waiters_;
+      const std::cv_status status = condvar_.wait_for( lock, dur );
+      --waiters_;
+      if( status == std::cv_status::timeout )
         return false;
     }
     return true;
@@ -76,15 +105,22 @@ public:
     lock_type lock( mtx_ );
     return queue_.size( );
   }
+  
+  inline unsigned consumer_waiters( ) const
+  {
+    lock_type lock( mtx_ );
+    return waiters_;
+  }
 
 private:
   typedef std::unique_lock< std::mutex >          lock_type;
-  typedef utils::Queue< element_type, Limited >   queue_type;
+  typedef utils::Queue< element_type, Limited, StorageType >  queue_type;
   
 private:
   mutable std::mutex        mtx_;
   std::condition_variable   condvar_;
   queue_type                queue_;
+  unsigned                  waiters_ = 0;
 }; // class CondvarQueue
 
 //--------------------------------------------------------------------------------
@@ -99,7 +135,7 @@ public:
   CondvarRingArray( const CondvarRingArray& )               = delete;
   CondvarRingArray& operator =( const CondvarRingArray& )   = delete;
   
-  CondvarRingArray( ) : arr_( nullptr ) { }
+  CondvarRingArray( ) : arr_( nullptr ), waiters_( 0 ) { }
   ~CondvarRingArray( ) { delete[ ] arr_; }
   
   void init( size_type size )
@@ -112,13 +148,31 @@ public:
   template < typename Type >
   bool push( Type&& src )
   {
-    bool result = false;
+    unsigned waiters = 0;
+    {
+      lock_type lock( mtx_ );
+      if( !put_element( std::forward< Type >( src ) ) )
+        return false;
+      waiters = waiters_;
+    }
+    utils::notify_waiters( condvar_, 1, waiters );
+    return true;
+  }
+  
+  // pushes till the array is full, returns the first element left out
+  template < typename InputIt >
+  InputIt push_bulk( InputIt first, InputIt last )
+  {
+    std::size_t pushed  = 0;
+    unsigned    waiters = 0;
     {
       lock_type lock( mtx_ );
-      result = put_element( std::forward< Type >( src ) );
+      for( ; ( first != last ) && put_element( *first ); ++first )
+        ++pushed;
+      waiters = waiters_;
     }
-    if( result ) condvar_.notify_one( );
-    return result;
+    utils::notify_waiters( condvar_, pushed, waiters );
+    return first;
   }
   
   template < typename Type >
@@ -133,7 +187,10 @@ public:
   {
     lock_type lock( mtx_ );
     while( !get_element( dst ) ) {
-      if( condvar_.wait_for( lock, dur ) == std::cv_status::timeout )
+      ++waiters_;
+      const std::cv_status status = condvar_.wait_for( lock, dur );
+      --waiters_;
+      if( status == std::cv_status::timeout )
         return false;
     }
     return true;
@@ -157,6 +214,12 @@ public:
     lock_type lock( mtx_ );
     return count_;
   }
+  
+  inline unsigned consumer_waiters( ) const
+  {
+    lock_type lock( mtx_ );
+    return waiters_;
+  }
 
 private:
   typedef std::unique_lock< std::mutex >  lock_type;
@@ -196,6 +259,7 @@ private:
   std::size_t               count_;
   std::size_t               head_;
   std::size_t               tail_;
+  unsigned                  waiters_;
 }; // class CondvarRingArray
 
 //--------------------------------------------------------------------------------
@@ -2,12 +2,17 @@
 # define _CONTAINER_GRAB_H_
 //--------------------------------------------------------------------------------
 # include <cassert>
+# include <cstddef>
+# include <iterator>
+# include <utility>
+# include <vector>
 //--------------------------------------------------------------------------------
 namespace concur {
 //--------------------------------------------------------------------------------
 
 // Grab allows invoke 'push', 'pop' and 'size' container methods multiple times
-// under the same lock.
+// under the same lock. 'push_range', 'pop_into' and 'swap_out' move whole
+// ranges at once, so a batch costs a single lock and no per-element overhead.
 //
 // Type 'ContainerT' must provide:
 //    void          unlock( );
@@ -15,6 +20,8 @@ namespace concur {
 //    bool          put_element( T&& src );
 //    bool          get_element( T&  dst );
 //    std::size_t   get_size( );
+//    InputIt       put_elements( InputIt first, InputIt last );
+//    std::size_t   get_elements( OutputIt dst, std::size_t max );
 
 //--------------------------------------------------------------------------------
 
@@ -55,6 +62,32 @@ public:
     return cont_->get_size( );
   }
   
+  // Copies elements till the container is full, returns the first one left
+  // out. Use move iterators to move them.
+  template < typename InputIt >
+  inline InputIt push_range( InputIt first, InputIt last ) {
+    assert( *this );
+    return cont_->put_elements( first, last );
+  }
+  
+  // Moves up to 'max' elements out, returns their count.
+  template < typename OutputIt >
+  inline std::size_t pop_into( OutputIt dst, std::size_t max ) {
+    assert( *this );
+    return cont_->get_elements( dst, max );
+  }
+  
+  // Moves all the elements out, replacing the contents of 'dst'. Its capacity
+  // is reused, so a consumer passing the same vector doesn't allocate.
+  template < typename T, typename Allocator >
+  std::size_t swap_out( std::vector< T, Allocator >& dst ) {
+    assert( *this );
+    dst.resize( cont_->get_size( ) );
+    const std::size_t count = cont_->get_elements( dst.data( ), dst.size( ) );
+    dst.resize( count );
+    return count;
+  }
+  
 private:
   container_type* cont_;
 }; // class ContainerGrab
@@ -0,0 +1,134 @@
+#ifndef MCMP_QUEUE_CELL_SEQ_H__
+#define MCMP_QUEUE_CELL_SEQ_H__
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+//------------------------------------------------------------------------------
+// Bounded lock-free MCMP queue with the same interface as MCMPSeq.
+//
+// Every cell carries a sequence number telling whose turn it is: the producer
+// of position P may write the cell when sequence == P, the consumer of
+// position P may read it when sequence == P + 1. Producers and consumers each
+// claim a position with a single CAS on their own index and never touch the
+// other side's index.
+//------------------------------------------------------------------------------
+template < typename T, typename Allocator = std::allocator< T > >
+class MCMPCellSeq {
+public:
+  typedef T ElementType;
+public:
+  explicit MCMPCellSeq(int64_t const aQueueSize) : fCells(0),
+    fQueueSize(aQueueSize), fReader(0), fWriter(0)
+  {
+    fCells = CellAllocator().allocate(fQueueSize);
+    for (int64_t i = 0; i < fQueueSize; ++i) {
+      new ( &(fCells[i].sequence) ) Sequence(i);
+    }
+  }
+  ~MCMPCellSeq() {
+    T value;
+    while (consume(value)) {
+    }
+    for (int64_t i = 0; i < fQueueSize; ++i) {
+      fCells[i].sequence.~Sequence();
+    }
+    CellAllocator().deallocate(fCells, fQueueSize);
+  }
+
+  bool produce(T const &aIn) {
+    return emplace(aIn);
+  }
+
+  template< typename... Args >
+  bool emplace(Args&&... aArgs) {
+    int64_t writer = fWriter.load(std::memory_order_relaxed);
+    Cell *cell = 0;
+    for (;;) {
+      cell = &fCells[writer % fQueueSize];
+      auto const sequence = cell->sequence.load(std::memory_order_acquire);
+      auto const diff = sequence - writer;
+      if (diff == 0) {
+        if (fWriter.compare_exchange_weak(writer, writer + 1,
+          std::memory_order_relaxed))
+        {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        writer = fWriter.load(std::memory_order_relaxed);
+      }
+    }
+
+    new ( cell->data() ) T(std::forward< Args >(aArgs)...);
+    cell->sequence.store(writer + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  bool consume(T &aOut) {
+    int64_t reader = fReader.load(std::memory_order_relaxed);
+    Cell *cell = 0;
+    for (;;) {
+      cell = &fCells[reader % fQueueSize];
+      auto const sequence = cell->sequence.load(std::memory_order_acquire);
+      auto const diff = sequence - (reader + 1);
+      if (diff == 0) {
+        if (fReader.compare_exchange_weak(reader, reader + 1,
+          std::memory_order_relaxed))
+        {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // empty
+      } else {
+        reader = fReader.load(std::memory_order_relaxed);
+      }
+    }
+
+    T *data = cell->data();
+    aOut = std::move(*data);
+    data->~T();
+    cell->sequence.store(reader + fQueueSize, std::memory_order_release);
+
+    return true;
+  }
+
+  // approximate while producers or consumers are active
+  int64_t fillCount() const {
+    auto const reader = fReader.load(std::memory_order_relaxed);
+    auto const writer = fWriter.load(std::memory_order_relaxed);
+    auto const count = writer - reader;
+    return (count < 0) ? 0 : ((count > fQueueSize) ? fQueueSize : count);
+  }
+
+  bool isFull() const {
+    return (fillCount() == fQueueSize);
+  }
+
+  bool isEmpty() const {
+    return (fillCount() == 0);
+  }
+private:
+  typedef std::atomic< int64_t > Sequence;
+
+  struct Cell {
+    Sequence sequence;
+    typename std::aligned_storage< sizeof(T), alignof(T) >::type storage;
+
+    T *data() { return reinterpret_cast< T * >(&storage); }
+  };
+
+  typedef typename std::allocator_traits< Allocator >::template
+    rebind_alloc< Cell > CellAllocator;
+private:
+  Cell *fCells;
+  int64_t const fQueueSize;
+  alignas(64) std::atomic< int64_t > fReader;
+  alignas(64) std::atomic< int64_t > fWriter;
+};
+//------------------------------------------------------------------------------
+#endif
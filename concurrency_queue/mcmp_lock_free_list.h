@@ -0,0 +1,209 @@
+#ifndef MCMP_LOCK_FREE_LIST_H__
+#define MCMP_LOCK_FREE_LIST_H__
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+#include <algorithm>
+//------------------------------------------------------------------------------
+// Unbounded lock-free MCMP list with the same interface as MCMPList.
+//
+// Producers append with a single exchange on the tail and then link the old
+// tail to the new item (as ScmpQueue::push_node does). Until the link is done
+// the list is torn and consumers see it as empty, so consume may miss.
+//
+// Consumers advance the head with a CAS. The item that stops being the head is
+// retired and freed later, once no consumer holds a hazard pointer to it.
+// Hazard records are taken from a per-list pool for the duration of a call, so
+// threads need no registration.
+//------------------------------------------------------------------------------
+template < typename T >
+struct MCMPLockFreeListItem {
+  typedef std::atomic< MCMPLockFreeListItem< T > * > Next;
+
+  Next next;
+  T data;
+};
+//------------------------------------------------------------------------------
+template < typename T,
+  typename Allocator = std::allocator< MCMPLockFreeListItem<T> > >
+class MCMPLockFreeList {
+public:
+  typedef T ElementType;
+public:
+  MCMPLockFreeList() : fHead(0), fTail(0), fRecords(0), fRecordCount(0) {
+    ListItem *root = createItem();
+    fHead.store(root, std::memory_order_relaxed);
+    fTail.store(root, std::memory_order_relaxed);
+  }
+  ~MCMPLockFreeList() {
+    auto ptr = fHead.load(std::memory_order_relaxed);
+    while (ptr) {
+      auto const next = ptr->next.load(std::memory_order_relaxed);
+      destroyItem(ptr);
+      ptr = next;
+    }
+
+    auto record = fRecords.load(std::memory_order_relaxed);
+    while (record) {
+      auto const next = record->nextRecord;
+      for (auto retired : record->retired) {
+        destroyItem(retired);
+      }
+      delete record;
+      record = next;
+    }
+  }
+
+  bool consume(T &aOut) {
+    HazardRecord &record = acquireRecord();
+
+    bool success = false;
+
+    for (;;) {
+      auto head = fHead.load(std::memory_order_seq_cst);
+      record.hazard[0].store(head, std::memory_order_seq_cst);
+      if (fHead.load(std::memory_order_seq_cst) != head) {
+        continue;
+      }
+
+      auto const next = head->next.load(std::memory_order_acquire);
+      if (!next) {
+        break; // no data or the list is torn by some producer
+      }
+
+      record.hazard[1].store(next, std::memory_order_seq_cst);
+      if (fHead.load(std::memory_order_seq_cst) != head) {
+        continue;
+      }
+
+      if (fHead.compare_exchange_strong(head, next,
+        std::memory_order_seq_cst))
+      {
+        // <next> is the new root now, only its data belongs to us
+        aOut = std::move(next->data);
+        record.hazard[0].store(0, std::memory_order_release);
+        record.hazard[1].store(0, std::memory_order_release);
+        retire(record, head);
+
+        success = true;
+        break;
+      }
+    }
+
+    record.hazard[0].store(0, std::memory_order_release);
+    record.hazard[1].store(0, std::memory_order_release);
+    releaseRecord(record);
+
+    return success;
+  }
+
+  void produce(T const &aIn) {
+    emplace(aIn);
+  }
+
+  template < typename... Args >
+  void emplace(Args&&... aArgs) {
+    auto const newItem = createItem(std::forward< Args >(aArgs)...);
+
+    // the old tail can't be freed until it gets <next>, so no hazard needed
+    auto const oldTail = fTail.exchange(newItem, std::memory_order_acq_rel);
+    oldTail->next.store(newItem, std::memory_order_release);
+  }
+private:
+  typedef MCMPLockFreeListItem< T > ListItem;
+
+  struct HazardRecord {
+    std::atomic< bool > active;
+    std::atomic< ListItem * > hazard[2];
+    HazardRecord *nextRecord;
+    std::vector< ListItem * > retired; // owned by the active holder
+
+    HazardRecord() : active(true), nextRecord(0) {
+      hazard[0].store(0, std::memory_order_relaxed);
+      hazard[1].store(0, std::memory_order_relaxed);
+    }
+  };
+
+  template < typename... Args >
+  static ListItem *createItem(Args&&... aArgs) {
+    Allocator allocator;
+
+    auto newItem = allocator.allocate(1);
+    new ( &(newItem->next) ) typename ListItem::Next();
+    newItem->next.store(0, std::memory_order_relaxed);
+    new ( &(newItem->data) ) T(std::forward< Args >(aArgs)...);
+    return newItem;
+  }
+
+  static void destroyItem(ListItem *aItem) {
+    Allocator allocator;
+
+    aItem->~ListItem();
+    allocator.deallocate(aItem, 1);
+  }
+
+  HazardRecord &acquireRecord() {
+    auto record = fRecords.load(std::memory_order_acquire);
+    for (; record; record = record->nextRecord) {
+      if (!record->active.load(std::memory_order_relaxed) &&
+        !record->active.exchange(true, std::memory_order_acquire))
+      {
+        return *record;
+      }
+    }
+
+    record = new HazardRecord;
+    auto head = fRecords.load(std::memory_order_relaxed);
+    do {
+      record->nextRecord = head;
+    } while (!fRecords.compare_exchange_weak(head, record,
+      std::memory_order_release, std::memory_order_relaxed));
+    fRecordCount.fetch_add(1, std::memory_order_relaxed);
+    return *record;
+  }
+
+  void releaseRecord(HazardRecord &aRecord) {
+    aRecord.active.store(false, std::memory_order_release);
+  }
+
+  void retire(HazardRecord &aRecord, ListItem *aItem) {
+    aRecord.retired.push_back(aItem);
+
+    auto const threshold = std::max< std::size_t >(64,
+      4 * fRecordCount.load(std::memory_order_relaxed));
+    if (aRecord.retired.size() >= threshold) {
+      scan(aRecord);
+    }
+  }
+
+  // frees retired items which are not protected by any hazard pointer
+  void scan(HazardRecord &aRecord) {
+    std::vector< ListItem * > hazards;
+    auto record = fRecords.load(std::memory_order_acquire);
+    for (; record; record = record->nextRecord) {
+      for (auto &hazard : record->hazard) {
+        if (auto const ptr = hazard.load(std::memory_order_seq_cst)) {
+          hazards.push_back(ptr);
+        }
+      }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    auto &retired = aRecord.retired;
+    auto const kept = std::partition(retired.begin(), retired.end(),
+      [&hazards](ListItem *aItem) {
+        return std::binary_search(hazards.begin(), hazards.end(), aItem);
+      });
+    std::for_each(kept, retired.end(), &destroyItem);
+    retired.erase(kept, retired.end());
+  }
+private:
+  alignas(64) std::atomic< ListItem * > fHead;
+  alignas(64) std::atomic< ListItem * > fTail;
+  alignas(64) std::atomic< HazardRecord * > fRecords;
+  std::atomic< std::size_t > fRecordCount;
+};
+//------------------------------------------------------------------------------
+#endif
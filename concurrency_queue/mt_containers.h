@@ -2,24 +2,29 @@
 # define _MT_CONTAINERS_H_
 //--------------------------------------------------------------------------------
 # include <cassert>
+# include <algorithm>
+# include <iterator>
 # include <queue>
 # include <mutex>
 //--------------------------------------------------------------------------------
 # include "non_pod_utils.h"
 # include "container_grab.h"
 # include "utils/queue_wrap.h"
+# include "utils/mem_utils.h"
 //--------------------------------------------------------------------------------
 namespace concur {
 //--------------------------------------------------------------------------------
 // simple thread-safe containers with mutex
 
-template < typename Type, typename MutexType = std::mutex, bool Limited = false >
+template < typename Type, typename MutexType = std::mutex, bool Limited = false,
+           typename StorageType = std::queue< Type > >
 class Queue
 { 
 public:
-  typedef Type                      element_type;
-  typedef MutexType                 mutex_type;
-  typedef ContainerGrab< Queue >    grab_type;
+  typedef Type                                                  element_type;
+  typedef MutexType                                             mutex_type;
+  typedef ContainerGrab< Queue >                                grab_type;
+  typedef utils::Queue< element_type, Limited, StorageType >    buffer_type;
   
   Queue( const Queue& )               = delete;
   Queue& operator =( const Queue& )   = delete;
@@ -61,6 +66,15 @@ public:
     lock_type lk( mtx_ );
     queue_.clear( );
   }
+  
+  // Exchanges the elements with 'buffer' under the lock in constant time. A
+  // consumer passing a drained buffer then pops the whole batch from it with
+  // no lock at all. Elements left in 'buffer' would be queued again.
+  void swap( buffer_type& buffer )
+  {
+    lock_type lk( mtx_ );
+    queue_.swap( buffer );
+  }
 
 private:
   friend grab_type;
@@ -85,23 +99,35 @@ private:
     return queue_.push( std::forward< T >( src ) );
   }
   
+  template < typename InputIt >
+  inline InputIt put_elements( InputIt first, InputIt last )
+  {
+    return queue_.push_range( first, last );
+  }
+  
+  template < typename OutputIt >
+  inline std::size_t get_elements( OutputIt dst, std::size_t max )
+  {
+    return queue_.pop_into( dst, max );
+  }
+  
 private:
   typedef std::unique_lock< mutex_type >          lock_type;
-  typedef utils::Queue< element_type, Limited >   queue_type;
   
 private:
   mutable mutex_type        mtx_;
-  queue_type                queue_;
+  buffer_type               queue_;
 }; // class Queue
 
 //--------------------------------------------------------------------------------
 
-template < typename Type, typename MutexType = std::mutex >
+template < typename Type, typename MutexType = std::mutex, typename IndexPolicy = utils::modulo_index >
 class RingArray
 { 
 public:
   typedef Type                          element_type;
   typedef MutexType                     mutex_type;
+  typedef IndexPolicy                   index_policy;
   typedef std::size_t                   size_type;
   typedef ContainerGrab< RingArray >    grab_type;
   
@@ -116,6 +142,7 @@ public:
   void init( size_type size )
   {
     assert( !arr_ && "array must be empty" );
+    index_.init( size );
     arr_ = new element_type[ arr_size_ = size ];
   }
            
@@ -174,19 +201,79 @@ private:
     ++count_;
     return true;
   }
+  
+  // The free slots make at most two runs: from the head up to the array end
+  // and from the array beginning. Same for the occupied ones from the tail.
+  
+  template < typename InputIt >
+  InputIt put_elements( InputIt first, InputIt last )
+  {
+    size_type room = arr_size_ - count_;
+    while( room && ( first != last ) ) {
+      const size_type pos = index_( head_ );
+      const size_type run = copy_run( first, last, arr_ + pos, ( std::min )( room, arr_size_ - pos ) );
+      head_  += run;
+      count_ += run;
+      room   -= run;
+    }
+    return first;
+  }
+  
+  template < typename OutputIt >
+  std::size_t get_elements( OutputIt dst, std::size_t max )
+  {
+    const size_type count = ( std::min )( count_, static_cast< size_type >( max ) );
+    for( size_type left( count ); left; ) {
+      const size_type pos = index_( tail_ );
+      const size_type run = ( std::min )( left, arr_size_ - pos );
+      dst = std::move( arr_ + pos, arr_ + pos + run, dst );
+      tail_  += run;
+      count_ -= run;
+      left   -= run;
+    }
+    return count;
+  }
     
 private:
   typedef std::unique_lock< mutex_type >  lock_type;
   typedef std::queue< element_type >      queue_type;
   
   inline element_type& at( size_type i ) {
-    return arr_[ i % arr_size_ ];
+    return arr_[ index_( i ) ];
+  }
+  
+  // copies up to 'max' elements to 'dst' advancing 'first', returns the count
+  template < typename InputIt >
+  static size_type copy_run( InputIt& first, InputIt last, element_type* dst, size_type max )
+  {
+    return copy_run( first, last, dst, max, typename std::iterator_traits< InputIt >::iterator_category( ) );
+  }
+  
+  template < typename InputIt >
+  static size_type copy_run( InputIt& first, InputIt last, element_type* dst, size_type max,
+                             std::random_access_iterator_tag )
+  {
+    const size_type count = ( std::min )( max, static_cast< size_type >( last - first ) );
+    std::copy( first, first + count, dst );
+    first += count;
+    return count;
+  }
+  
+  template < typename InputIt >
+  static size_type copy_run( InputIt& first, InputIt last, element_type* dst, size_type max,
+                             std::input_iterator_tag )
+  {
+    size_type count = 0;
+    for( ; ( count < max ) && ( first != last ); ++count, ++first )
+      dst[ count ] = *first;
+    return count;
   }
   
 private:
   mutable mutex_type        mtx_;
   element_type*             arr_;
   size_type                 arr_size_;
+  index_policy              index_;
   size_type                 count_;
   size_type                 head_;
   size_type                 tail_;
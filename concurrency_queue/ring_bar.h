@@ -13,7 +13,8 @@
 // other words it can't get a READY element if there is a NOT-READY one before it.
 // It means if someone gets stuck in processing or loses an obtained element, it
 // may block the whole ring. Hence every thread must always release the elements
-// and do it as fast as possible.
+// and do it as fast as possible. UnorderedRingBar lets the master pass by such
+// an element instead.
 // 
 // Type must have default constructor.
 //
@@ -21,7 +22,8 @@
 namespace concur {
 //--------------------------------------------------------------------------------
 
-template < typename Type, std::size_t Alignment >
+template < typename Type, std::size_t Alignment, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
 class ALIGNAS( Alignment ) RingBar
 {
 private:
@@ -39,8 +41,8 @@ private:
   };
   
 public:
-  typedef RingBar< Type, Alignment >    this_type;
-  typedef Type                          element_type;
+  typedef RingBar< Type, Alignment, IndexPolicy, StoragePolicy >  this_type;
+  typedef Type                                    element_type;
   
   RingBar( const RingBar& )             = delete;
   RingBar& operator =( const RingBar& ) = delete;
@@ -118,7 +120,7 @@ private:
   typedef uint_fast32_t                           size_type;
   typedef std::atomic< size_type >                atomic_size_type;
   typedef std::atomic< int_fast32_t >             atomic_counter_type;
-  typedef utils::aligned_ring< Node, size_type >  ring_type;
+  typedef utils::aligned_ring< Node, size_type, IndexPolicy, StoragePolicy >  ring_type;
 
 private:
   ring_type            ring_;
@@ -2,7 +2,12 @@
 # define _SCMP_QUEUE_H_
 //--------------------------------------------------------------------------------
 # include <cassert>
+# include <cstddef>
 # include <atomic>
+# include <new>
+# include <utility>
+//--------------------------------------------------------------------------------
+# include "utils/node_pool.h"
 //--------------------------------------------------------------------------------
 namespace concur {
 //--------------------------------------------------------------------------------
@@ -20,9 +25,19 @@ namespace concur {
  * - Data type must has default constructor
  * - Data stays alive in a node until next one is popped
  * - Data is pushed and popped with move-assign operator
+ * 
+ * 'consume_all'/'pop_all' drain everything bound so far in one pass and tell
+ * whether they stopped at the real end of the queue or at a gap. The drained
+ * nodes go back to 'NodePolicy' with a single 'give_chain' at the end, and a
+ * node isn't released before its element has been consumed: an element whose
+ * 'func' throws stays in the queue.
+ * 
+ * Node memory comes from 'NodePolicy' (see utils/node_pool.h). Producers take
+ * nodes, the consumer gives them back, so with 'utils::recycled_nodes' nodes
+ * circulate between the threads without touching the heap in steady state.
 */
 
-template < typename T >
+template < typename T, typename NodePolicy = utils::heap_nodes >
 class ScmpQueue
 {
 public:
@@ -30,19 +45,19 @@ public:
   ScmpQueue& operator =( const ScmpQueue& ) = delete;
 
   ScmpQueue( )
-    : head_( new Node ), tail_( head_ )
+    : head_( create_node( ) ), tail_( head_ )
   { }
 
   ~ScmpQueue( )
   {
     while( pop_head( ) ) ;
-    delete head_;
+    destroy_node( head_ );
   }
 
   template < typename ...Args >
   bool push( Args&& ...args )
   {
-    Node* new_node = new Node( std::forward<Args>( args )... );
+    Node* new_node = create_node( std::forward<Args>( args )... );
     push_node( new_node );
     return true;
   }
@@ -57,6 +72,46 @@ public:
     return false;
   }
 
+  struct DrainResult
+  {
+    std::size_t count;  // number of consumed elements
+    bool        gap;    // stopped before the tail: at a gap torn by a producer
+                        // or more elements were pushed meanwhile
+  };
+
+  // Calls 'func( T&& )' for every element up to the first gap or the end.
+  template < typename Func >
+  DrainResult consume_all( Func func )
+  {
+    DrainResult result = { 0, false };
+
+    NodeChain drained;
+    Node* first = head_->next.load( std::memory_order_acquire ); // <READ>
+    try {
+      while( first ) {
+        func( std::move( first->data ) );
+        drained.add( head_ );
+        head_ = first;
+        ++result.count;
+        first = first->next.load( std::memory_order_acquire ); // <READ>
+      }
+    } catch( ... ) {
+      drained.give_to( nodes_ );
+      throw;
+    }
+    drained.give_to( nodes_ );
+
+    // the last bound node isn't the tail: some producer has made a gap after it
+    result.gap = ( tail_.load( std::memory_order_acquire ) != head_ );
+    return result;
+  }
+
+  template < typename OutputIt >
+  inline DrainResult pop_all( OutputIt dst )
+  {
+    return consume_all( [ &dst ]( T&& data ) { *dst++ = std::move( data ); } );
+  }
+
 private:
   struct Node
   {
@@ -72,6 +127,47 @@ private:
     { }
   };
 
+  typedef typename NodePolicy::template pool< Node > node_pool_type;
+
+  template < typename ...Args >
+  Node* create_node( Args&& ...args )
+  {
+    void* ptr = nodes_.take( );
+    try {
+      return new( ptr ) Node( std::forward<Args>( args )... );
+    } catch( ... ) {
+      nodes_.discard( ptr ); // a producer may not give nodes back
+      throw;
+    }
+  }
+
+  inline void destroy_node( Node* node )
+  {
+    node->~Node( );
+    nodes_.give( node );
+  }
+
+  // destroyed nodes waiting to be given back at once
+  struct NodeChain
+  {
+    void*       first = nullptr;
+    std::size_t count = 0;
+
+    inline void add( Node* node )
+    {
+      node->~Node( );
+      utils::chain_next( node ) = first;
+      first = node;
+      ++count;
+    }
+
+    inline void give_to( node_pool_type& nodes )
+    {
+      if( count )
+        nodes.give_chain( first, count );
+    }
+  };
+
   inline void push_node( Node* new_tail ) 
   {
     Node* old_tail = tail_.exchange( new_tail, std::memory_order_acq_rel ); // <TEAR>
@@ -94,11 +190,12 @@ private:
       // there is no data or this queue is torn apart by some P-thread
       return nullptr;
     } else {
-      delete head_;
+      destroy_node( head_ );
       return head_ = first;
     }
   }
 
+  node_pool_type      nodes_;
   Node*               head_; // pop elements from (used only by C-thread)
   std::atomic<Node*>  tail_; // push elements to
 }; // class ScmpQueue
@@ -1,10 +1,17 @@
 # ifndef _SCMP_RING_ARRAY_H_
 # define _SCMP_RING_ARRAY_H_
 //--------------------------------------------------------------------------------
+# include <cstddef>
 # include <cstdlib>
 # include <cassert>
 # include <atomic>
 # include <memory>
+# include <iterator>
+# include <new>
+# include <type_traits>
+# include <utility>
+//--------------------------------------------------------------------------------
+# include "utils/mem_utils.h"
 //--------------------------------------------------------------------------------
 
 # define CONCUR_ALIGNMENT 64
@@ -22,8 +29,26 @@
 //--------------------------------------------------------------------------------
 namespace concur {
 //--------------------------------------------------------------------------------
+//
+// Slots hold raw storage: an element is constructed in place by 'try_emplace'
+// ('push' is emplacing a copy) and destroyed when the consumer commits the pop,
+// so T needn't be default-constructible. 'front( )' and 'consume( Func )' let
+// the consumer read the element in place before the slot is given back.
+//
+// A slot is reserved before the element is constructed: a throwing constructor
+// leaves it unpublished and stalls the consumer on it.
+//
+// 'producer_claim( )' reserves a slot with a constructed element the producer
+// fills in place and publishes by 'producer_commit( ptr )', the same way as
+// RingBar's visitors do. Commits may come in any order, but the consumer stops
+// at the first uncommitted slot, so a claimed slot must be committed soon. A
+// slot remembers its element is constructed apart from being published, so the
+// destructor also destroys elements claimed but never committed.
+//
+//--------------------------------------------------------------------------------
 
-template < typename T, std::size_t Alignment >
+template < typename T, std::size_t Alignment, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
 class ScmpRingArray
 {
 private:
@@ -40,10 +65,17 @@ private:
     Node( const Node& )             = delete;
     Node& operator =( const Node& ) = delete;
     
-    Node( ) : flag( false ), data( ) { }
+    enum : uint8_t { EMPTY, BUILT, READY };  // BUILT: claimed, not committed
+    
+    Node( ) : state( EMPTY ) { }
+    ~Node( ) { if( state.load( RLX ) != EMPTY ) data( ).~T( ); }
+    
+    inline bool ready( ) const { return state.load( AQR ) == READY; }
     
-    std::atomic< bool > flag;
-    T                   data;
+    inline T& data( ) { return *reinterpret_cast< T* >( &storage ); }
+    
+    std::atomic< uint8_t >                                          state;
+    typename std::aligned_storage< sizeof( T ), ALIGNOF( T ) >::type  storage;
   }; 
   
 public:
@@ -57,13 +89,19 @@ public:
   
 public:
   ScmpRingArray( )
-    : mem_( nullptr ), arr_( nullptr ), arr_size_( 0 ), head_( 0 ), tail_( 0 )
+    : arr_( nullptr ), arr_size_( 0 ), head_( 0 ), tail_( 0 )
   { }
-  ~ScmpRingArray( ) { std::free( mem_ ); }
+  ~ScmpRingArray( )
+  {
+    for( size_type i( 0 ); i < arr_size_; ++i )
+      arr_[ i ].~Node( );
+    storage_.deallocate( arr_, sizeof( Node ) * arr_size_ );
+  }
   
   void init( unsigned size )
   {
     assert( arr_ == nullptr );
+    index_.init( size );
     if( allocate_storage( size ) ) {
       pcounter_.store( arr_size_ = size );
 
@@ -72,56 +110,180 @@ public:
   }
 
   template < typename Type >
-  bool push( Type&& src )
+  inline bool push( Type&& src )
   {
-    if( pcounter_.fetch_sub( 1, AQR ) <= 0 ) {
-      pcounter_.fetch_add( 1, RLX );
+    return try_emplace( std::forward< Type >( src ) );
+  }
+  
+  // Constructs an element from 'args' right in the slot. Returns false if the
+  // ring is full.
+  template < typename ...Args >
+  bool try_emplace( Args&& ...args )
+  {
+    Node* node = claim_node( );
+    if( !node )
       return false;
-    }
-    
-    Node& node = at( head_.fetch_add( 1, RLX ) );
-    node.data = std::forward< Type >( src );
-    node.flag.store( true, RLS );
     
+    new( &node->storage ) T( std::forward< Args >( args )... );
+    node->state.store( Node::READY, RLS );
     return true;
   }
 
+  // Reserves a slot and default-initializes an element in it. Returns nullptr if
+  // the ring is full.
+  T* producer_claim( )
+  {
+    Node* node = claim_node( );
+    return node ? built( node, new( &node->storage ) T ) : nullptr;
+  }
+  
+  // Same with the element constructed from 'args'.
+  template < typename Arg, typename ...Args >
+  T* producer_claim( Arg&& arg, Args&& ...args )
+  {
+    Node* node = claim_node( );
+    return node ? built( node, new( &node->storage ) T( std::forward< Arg >( arg ), std::forward< Args >( args )... ) )
+                : nullptr;
+  }
+  
+  // Publishes the element returned by 'producer_claim( )'.
+  inline void producer_commit( const T* ptr )
+  {
+    to_node( ptr )->state.store( Node::READY, RLS );
+  }
+
   template < typename Type >
   bool pop( Type& dst )
   {
-    bool expected = true;
-    
+    T* ptr = front( );
+    if( ptr ) {
+      dst = std::move( *ptr );
+      pop_commit( );
+    }
+    return ptr != nullptr;
+  }
+  
+  // The element to be popped next or nullptr. It stays in the ring till
+  // 'pop_commit( )'.
+  inline T* front( )
+  {
+    Node& node = at( tail_ );
+    return node.ready( ) ? &node.data( ) : nullptr;
+  }
+  
+  // Destroys the element returned by 'front( )' and gives its slot back.
+  inline void pop_commit( )
+  {
     Node& node = at( tail_ );
-    if( node.flag.compare_exchange_strong( expected, false, AQR, RLX ) ) {
-      dst = std::move( node.data );
-      pcounter_.fetch_add( 1, RLS );
-      ++tail_;
+    assert( node.state.load( RLX ) == Node::READY );
+    node.data( ).~T( );
+    node.state.store( Node::EMPTY, RLX );
+    pcounter_.fetch_add( 1, RLS );
+    ++tail_;
+  }
+  
+  // Calls 'func( T& )' for the next element in place and pops it. If 'func'
+  // throws the element stays in the ring. Returns false if the ring is empty.
+  template < typename Func >
+  bool consume( Func&& func )
+  {
+    T* ptr = front( );
+    if( !ptr )
+      return false;
+    func( *ptr );
+    pop_commit( );
+    return true;
+  }
+  
+  // Pushes elements of [first, last) reserving slots for the whole run with
+  // a single 'pcounter_' and 'head_' RMW. If the ring is nearly full only the
+  // leading part of the range is pushed. Returns number of pushed elements.
+  template < typename ForwardIt >
+  unsigned push_bulk( ForwardIt first, ForwardIt last )
+  {
+    const int_fast32_t count = static_cast< int_fast32_t >( std::distance( first, last ) );
+    if( count <= 0 )
+      return 0;
+    
+    const int_fast32_t free  = pcounter_.fetch_sub( count, AQR );
+    const int_fast32_t taken = ( free >= count ) ? count : ( ( free > 0 ) ? free : 0 );
+    if( taken != count )
+      pcounter_.fetch_add( count - taken, RLX );
+    if( taken == 0 )
+      return 0;
+    
+    size_type i = head_.fetch_add( static_cast< size_type >( taken ), RLX );
+    for( int_fast32_t n( 0 ); n < taken; ++n, ++first ) {
+      Node& node = at( i++ );
+      new( &node.storage ) T( *first );
+      node.state.store( Node::READY, RLS );
+    }
+    
+    return static_cast< unsigned >( taken );
+  }
+  
+  // Pops up to 'max' elements into 'out' stopping at the first not published
+  // node. Freed slots are returned to producers with a single RMW. Returns
+  // number of popped elements.
+  template < typename OutputIt >
+  unsigned pop_bulk( OutputIt out, unsigned max )
+  {
+    unsigned count = 0;
+    for( ; count < max; ++count, ++tail_ ) {
+      Node& node = at( tail_ );
+      if( !node.ready( ) )
+        break;
+      *out++ = std::move( node.data( ) );
+      node.data( ).~T( );
+      node.state.store( Node::EMPTY, RLX );
     }
     
-    return expected;
+    if( count )
+      pcounter_.fetch_add( static_cast< int_fast32_t >( count ), RLS );
+    return count;
   }
 
 private:
   inline Node& at( size_type i ) {
-    return arr_[ i % arr_size_ ];
+    return arr_[ index_( i ) ];
   }
   
-  bool allocate_storage( unsigned size )
+  Node* claim_node( )
   {
-    std::size_t mem_size = sizeof( Node ) * size + ALIGNOF( Node );
-    if( ( mem_ = std::malloc( mem_size ) ) ) {
-      const uint64_t addr     = reinterpret_cast< uint64_t >( mem_ );
-      const uint64_t aligned  = addr + ( ALIGNOF( Node ) - addr % ALIGNOF( Node ) );
-      assert( ( aligned >= addr ) && !( aligned % ALIGNOF( Node ) ) );
-      arr_ = reinterpret_cast< Node* >( aligned );
-      return true;
+    if( pcounter_.fetch_sub( 1, AQR ) <= 0 ) {
+      pcounter_.fetch_add( 1, RLX );
+      return nullptr;
     }
-    return false;
+    return &at( head_.fetch_add( 1, RLX ) );
+  }
+  
+  // marks the claimed element constructed, so it's destroyed along with the ring
+  static inline T* built( Node* node, T* ptr )
+  {
+    node->state.store( Node::BUILT, RLX );
+    return ptr;
+  }
+  
+  static inline Node* to_node( const T* ptr )
+  {
+    return const_cast< Node* >(
+          reinterpret_cast< const Node* >(
+            reinterpret_cast< const char* >( ptr ) - offsetof( Node, storage )
+            )
+          );
+  }
+  
+  bool allocate_storage( unsigned size )
+  {
+    arr_ = static_cast< Node* >( storage_.allocate( ALIGNOF( Node ), sizeof( Node ) * size ) );
+    assert( !( reinterpret_cast< uint64_t >( arr_ ) % ALIGNOF( Node ) ) );
+    return arr_ != nullptr;
   }
   
-  void*                           mem_;
   Node*                           arr_;
   size_type                       arr_size_;
+  IndexPolicy                     index_;
+  StoragePolicy                   storage_;
   ALIGNAS( Alignment )   atomic_counter_type   pcounter_;
   ALIGNAS( Alignment )   atomic_size_type      head_;
   ALIGNAS( Alignment )   size_type             tail_;
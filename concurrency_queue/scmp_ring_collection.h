@@ -6,14 +6,16 @@
 namespace concur {
 //--------------------------------------------------------------------------------
 
-template < typename Type, std::size_t Alignment >
-class ScmpRingCollection : public RingBar< Type, Alignment >
+template < typename Type, std::size_t Alignment, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
+class ScmpRingCollection : public RingBar< Type, Alignment, IndexPolicy, StoragePolicy >
 {
 public:
-  typedef typename RingBar< Type, Alignment >::element_type element_type;
+  typedef RingBar< Type, Alignment, IndexPolicy, StoragePolicy >   base_type;
+  typedef typename base_type::element_type          element_type;
   
 public:
-  ScmpRingCollection( ) : RingBar< Type, Alignment >( ) { }
+  ScmpRingCollection( ) : base_type( ) { }
   
   inline element_type* producer_fetch( ) {
     return this->visitor_fetch( );
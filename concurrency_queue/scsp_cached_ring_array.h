@@ -0,0 +1,89 @@
+# ifndef _SCSP_CACHED_RING_ARRAY_H_
+# define _SCSP_CACHED_RING_ARRAY_H_
+//--------------------------------------------------------------------------------
+# include <cstdlib>
+# include <cassert>
+# include <atomic>
+# include <memory>
+//--------------------------------------------------------------------------------
+# include "utils/mem_utils.h"
+//--------------------------------------------------------------------------------
+//
+// SCSP ring with the same interface as ScspRingArray, but elements are stored
+// densely without per-element flags. Producer and consumer publish their
+// positions in separate cache lines, and each side keeps a private copy of the
+// other's position, re-reading the shared one only when the copy says the ring
+// is full (producer) or empty (consumer).
+//
+// Type must have default constructor.
+//
+//--------------------------------------------------------------------------------
+namespace concur {
+//--------------------------------------------------------------------------------
+
+template < typename Type, std::size_t Alignment = 64, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
+class ScspCachedRingArray
+{
+public:
+  typedef uint_fast32_t     size_type;
+  typedef Type              element_type;
+
+  ScspCachedRingArray( const ScspCachedRingArray& )             = delete;
+  ScspCachedRingArray& operator =( const ScspCachedRingArray& ) = delete;
+
+public:
+  ScspCachedRingArray( ) = default;
+
+  void init( unsigned size )
+  {
+    ring_.init( size );
+  }
+
+  template < typename T >
+  bool push( T&& src )
+  {
+    const size_type head = head_.load( std::memory_order_relaxed );
+    if( head - tail_cache_ == ring_.size( ) ) {
+      tail_cache_ = tail_.load( std::memory_order_acquire );
+      if( head - tail_cache_ == ring_.size( ) )
+        return false;
+    }
+
+    ring_.at( head ) = std::forward< T >( src );
+    head_.store( head + 1, std::memory_order_release );
+    return true;
+  }
+
+  template < typename T >
+  bool pop( T& dst )
+  {
+    const size_type tail = tail_.load( std::memory_order_relaxed );
+    if( tail == head_cache_ ) {
+      head_cache_ = head_.load( std::memory_order_acquire );
+      if( tail == head_cache_ )
+        return false;
+    }
+
+    dst = std::move( ring_.at( tail ) );
+    tail_.store( tail + 1, std::memory_order_release );
+    return true;
+  }
+
+private:
+  typedef utils::aligned_ring< element_type, size_type, IndexPolicy, StoragePolicy >  ring_type;
+  typedef std::atomic< size_type >                                     atomic_size_type;
+
+  ring_type                                 ring_;
+
+  ALIGNAS( Alignment ) atomic_size_type     head_       = { 0 }; // written by producer
+  size_type                                 tail_cache_ = 0;     // producer's view of <tail_>
+
+  ALIGNAS( Alignment ) atomic_size_type     tail_       = { 0 }; // written by consumer
+  size_type                                 head_cache_ = 0;     // consumer's view of <head_>
+}; // class ScspCachedRingArray
+
+//--------------------------------------------------------------------------------
+} // namespace concur
+//--------------------------------------------------------------------------------
+# endif // _SCSP_CACHED_RING_ARRAY_H_
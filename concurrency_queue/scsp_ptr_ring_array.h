@@ -11,7 +11,8 @@
 namespace concur {
 //--------------------------------------------------------------------------------
 
-template < typename Type, std::size_t Alignment = 64 >
+template < typename Type, std::size_t Alignment = 64, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
 class ScspPtrRingArray
 {
 public:
@@ -68,7 +69,7 @@ public:
   }
 
 private:
-  typedef utils::aligned_ring< Node, size_type >   ring_type;
+  typedef utils::aligned_ring< Node, size_type, IndexPolicy, StoragePolicy >   ring_type;
   
   inline Node& at( size_type i ) { return ring_.at( i ); }
   
@@ -5,13 +5,24 @@
 # include <cassert>
 # include <atomic>
 # include <memory>
+# include <new>
+# include <type_traits>
+# include <utility>
 //--------------------------------------------------------------------------------
 # include "utils/mem_utils.h"
 //--------------------------------------------------------------------------------
 namespace concur {
 //--------------------------------------------------------------------------------
+//
+// Elements are constructed right in the slots ('try_emplace', 'push' emplaces a
+// copy) and destroyed on 'pop_commit( )', so Type needn't be default-
+// constructible. The consumer may read an element in place with 'front( )' or
+// 'consume( Func )' before its slot is given back.
+//
+//--------------------------------------------------------------------------------
 
-template < typename Type, std::size_t Alignment = 64 >
+template < typename Type, std::size_t Alignment = 64, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
 class ScspRingArray
 {
 private:
@@ -21,33 +32,36 @@ private:
     Node( const Node& )             = delete;
     Node& operator =( const Node& ) = delete;
     
-    Node( ) : flag( false ), data( ) { }
+    Node( ) : flag( false ) { }
+    ~Node( ) { if( flag.load( std::memory_order_relaxed ) ) data( ).~Type( ); }
     
-    template < typename T >
-    bool put( T&& src )
+    template < typename ...Args >
+    bool emplace( Args&& ...args )
     {
       if( flag.load( std::memory_order_acquire ) )
         return false;
       
-      data = std::forward< T >( src );
+      new( &storage ) Type( std::forward< Args >( args )... );
       flag.store( true, std::memory_order_release );
       return true;
     }
     
-    template < typename T >
-    bool take( T& dst )
+    inline Type* front( )
     {
-      if( !flag.load( std::memory_order_acquire ) )
-        return false;
-      
-      dst = std::move( data );
+      return flag.load( std::memory_order_acquire ) ? &data( ) : nullptr;
+    }
+    
+    inline void release( )
+    {
+      data( ).~Type( );
       flag.store( false, std::memory_order_release );
-      return true;
     }
     
   private:
-    std::atomic< bool > flag;
-    Type                data;
+    inline Type& data( ) { return *reinterpret_cast< Type* >( &storage ); }
+    
+    std::atomic< bool >                                                   flag;
+    typename std::aligned_storage< sizeof( Type ), ALIGNOF( Type ) >::type  storage;
   }; 
   
 public:
@@ -66,9 +80,17 @@ public:
   }
 
   template < typename T >
-  bool push( T&& src )
+  inline bool push( T&& src )
+  {
+    return try_emplace( std::forward< T >( src ) );
+  }
+  
+  // Constructs an element from 'args' right in the slot. Returns false if the
+  // ring is full.
+  template < typename ...Args >
+  bool try_emplace( Args&& ...args )
   {
-    if( at( head_ ).put( std::forward< T >( src ) ) ) {
+    if( at( head_ ).emplace( std::forward< Args >( args )... ) ) {
       ++head_;
       return true;
     }
@@ -78,15 +100,39 @@ public:
   template < typename T >
   bool pop( T& dst )
   {
-    if( at( tail_ ).take( dst ) ) {
-      ++tail_;
-      return true;
+    element_type* ptr = front( );
+    if( ptr ) {
+      dst = std::move( *ptr );
+      pop_commit( );
     }
-    return false;
+    return ptr != nullptr;
+  }
+  
+  // The element to be popped next or nullptr. It stays in the ring till
+  // 'pop_commit( )'.
+  inline element_type* front( ) { return at( tail_ ).front( ); }
+  
+  // Destroys the element returned by 'front( )' and gives its slot back.
+  inline void pop_commit( )
+  {
+    at( tail_++ ).release( );
+  }
+  
+  // Calls 'func( Type& )' for the next element in place and pops it. If 'func'
+  // throws the element stays in the ring. Returns false if the ring is empty.
+  template < typename Func >
+  bool consume( Func&& func )
+  {
+    element_type* ptr = front( );
+    if( !ptr )
+      return false;
+    func( *ptr );
+    pop_commit( );
+    return true;
   }
 
 private:
-  typedef utils::aligned_ring< Node, size_type > ring_type;
+  typedef utils::aligned_ring< Node, size_type, IndexPolicy, StoragePolicy > ring_type;
   
   inline Node& at( size_type i ) { return ring_.at( i ); }
   
@@ -22,8 +22,12 @@ INCLUDEPATH *= ../../../
 SOURCES += \
     ../src/main.cpp \
     ../src/test_helpers.cpp \
-    ../src/test_scene_1.cpp
+    ../src/test_scene_1.cpp \
+    ../src/test_scene_2.cpp \
+    ../src/test_scene_3.cpp
 
 HEADERS += \
     ../src/test_helpers.h \
-    ../src/test_scene_1.h
+    ../src/test_scene_1.h \
+    ../src/test_scene_2.h \
+    ../src/test_scene_3.h
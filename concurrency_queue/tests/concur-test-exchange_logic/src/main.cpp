@@ -116,6 +116,7 @@ const char* const LIST =
     "\n  CASE_condvar_queue_limited"
     "\n  CASE_condvar_ring_array"
     "\n  CASE_scmp_queue"
+    "\n  CASE_scmp_queue_recycled"
     "\n  CASE_scmp_ring_array"
     "\n  CASE_scmp_ring_array_a64"
     "\n  CASE_scmp_ring_array_a128"
@@ -123,6 +124,24 @@ const char* const LIST =
     "\n  CASE_scsp_ring_array_a64"
     "\n  CASE_scsp_ptr_ring_array_noalg"
     "\n  CASE_scsp_ptr_ring_array_a64"
+    "\n  CASE_scsp_cached_ring_array"
+    "\n  CASE_waitable_scmp_ring_array"
+    "\n  CASE_waitable_scmp_queue"
+    "\n  CASE_mt_ring_array_std_pow2"
+    "\n  CASE_scmp_ring_array_a64_pow2"
+    "\n  CASE_scsp_ring_array_a64_pow2"
+    "\n  CASE_scsp_ptr_ring_array_a64_pow2"
+    "\n  CASE_mt_queue_std_circular"
+    "\n  CASE_condvar_queue_circular"
+    "\n  CASE_waitable_basic"
+    "\n  CASE_wakeup_scsp_ring_array_spin"
+    "\n  CASE_wakeup_condvar_queue"
+    "\n  CASE_wakeup_waitable_scsp_ring_array"
+    "\n  CASE_wakeup_waitable_scmp_ring_array"
+    "\n  CASE_wakeup_waitable_scmp_queue"
+    "\n  CASE_unordered_ring_bar_basic"
+    "\n  CASE_stall_ring_bar"
+    "\n  CASE_stall_unordered_ring_bar"
     ;
 
 //--------------------------------------------------------------------------------
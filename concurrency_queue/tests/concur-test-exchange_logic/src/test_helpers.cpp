@@ -5,10 +5,74 @@
 #   include <WinBase.h>
 # else
 #   include <sched.h>
+#   include <sys/resource.h>
 # endif
 //--------------------------------------------------------------------------------
 # include <boost/test/test_tools.hpp>
 # include <boost/timer/timer.hpp>
+//--------------------------------------------------------------------------------
+# include <cstdlib>
+# include <new>
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+namespace {
+//--------------------------------------------------------------------------------
+
+std::atomic< uint64_t > allocations( 0 );
+std::atomic< unsigned > counting_scopes( 0 );
+
+//--------------------------------------------------------------------------------
+} // anonymous namespace
+//--------------------------------------------------------------------------------
+
+// counting replacements, the other forms of 'new' and 'delete' end up here
+void* operator new( std::size_t size )
+{
+  if( counting_scopes.load( std::memory_order_relaxed ) )
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+  if( void* ptr = std::malloc( size ? size : 1 ) )
+    return ptr;
+  throw std::bad_alloc( );
+}
+
+void operator delete( void* ptr ) noexcept
+{
+  std::free( ptr );
+}
+
+void operator delete( void* ptr, std::size_t ) noexcept
+{
+  std::free( ptr );
+}
+
+uint64_t allocation_count( )
+{
+  return allocations.load( std::memory_order_relaxed );
+}
+
+AllocationCounting::AllocationCounting( )
+{
+  counting_scopes.fetch_add( 1, std::memory_order_seq_cst );
+}
+
+AllocationCounting::~AllocationCounting( )
+{
+  counting_scopes.fetch_sub( 1, std::memory_order_seq_cst );
+}
+
+int64_t context_switch_count( )
+{
+# ifdef _WIN32
+  return 0;
+# else
+  rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) )
+    return 0;
+  return static_cast< int64_t >( usage.ru_nvcsw ) + usage.ru_nivcsw;
+# endif
+}
+
 //--------------------------------------------------------------------------------
 
 std::string CpuTimes::str( ) const
@@ -33,6 +33,24 @@ struct CpuTimes
 
 void set_thread_affinity( unsigned cpu );
 
+// 'operator new' calls made by the process while counting, which is on only
+// while some AllocationCounting is alive; the rest of the time the replacement
+// 'operator new' costs a relaxed load more than the default one
+uint64_t allocation_count( );
+
+struct AllocationCounting
+{
+  AllocationCounting( );
+  ~AllocationCounting( );
+  
+  AllocationCounting( const AllocationCounting& )             = delete;
+  AllocationCounting& operator =( const AllocationCounting& ) = delete;
+};
+
+// voluntary and involuntary context switches of the process so far, 0 where
+// unknown
+int64_t context_switch_count( );
+
 //--------------------------------------------------------------------------------
 
 struct TestConfig
@@ -134,6 +152,7 @@ struct SceneDesc
   ThreadDesc    prod_desc;
   ThreadDesc    cons_desc;
   counter_type  operations;
+  bool          measure_latency = false;  // the threads stamp their items
 };
 
 //--------------------------------------------------------------------------------
@@ -11,14 +11,16 @@
 # include <scmp_ring_array.h>
 # include <scsp_ring_array.h>
 # include <scsp_ptr_ring_array.h>
+# include <scsp_cached_ring_array.h>
+# include <waitable_container.h>
 //--------------------------------------------------------------------------------
 namespace scene_1 {
 //--------------------------------------------------------------------------------
 
-template < typename ElemenT >
-struct ContainerTraits< concur::RingArray< ElemenT > >
+template < typename ElemenT, typename IndexPolicy >
+struct ContainerTraits< concur::RingArray< ElemenT, std::mutex, IndexPolicy > >
 {
-  typedef concur::RingArray< ElemenT > container_type;
+  typedef concur::RingArray< ElemenT, std::mutex, IndexPolicy > container_type;
   
   static SceneDesc::thread_func_type prod( ) { return &pexec_grab< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec_grab< container_type >; }
@@ -28,14 +30,14 @@ struct ContainerTraits< concur::RingArray< ElemenT > >
 
 //--------------------------------------------------------------------------------
 
-template < typename ElemenT >
-struct ContainerTraits< concur::CondvarQueue< ElemenT > > {
-  typedef concur::CondvarQueue< ElemenT > container_type;
+template < typename ElemenT, typename StorageT >
+struct ContainerTraits< concur::CondvarQueue< ElemenT, false, StorageT > > {
+  typedef concur::CondvarQueue< ElemenT, false, StorageT > container_type;
   
-  static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
+  static SceneDesc::thread_func_type prod( ) { return &pexec_stamp< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec_wait< container_type >; }
   
-  static void apply_to_scene( SceneDesc& ) { }
+  static void apply_to_scene( SceneDesc& desc ) { desc.measure_latency = true; }
 };
 
 //--------------------------------------------------------------------------------
@@ -44,17 +46,17 @@ template < typename ElemenT >
 struct ContainerTraits< concur::CondvarRingArray< ElemenT > > {
   typedef concur::CondvarRingArray< ElemenT > container_type;
   
-  static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
+  static SceneDesc::thread_func_type prod( ) { return &pexec_stamp< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec_wait< container_type >; }
   
-  static void apply_to_scene( SceneDesc& ) { }
+  static void apply_to_scene( SceneDesc& desc ) { desc.measure_latency = true; }
 };
 
 //--------------------------------------------------------------------------------
 
-template < typename ElemenT >
-struct ContainerTraits< concur::ScmpQueue< ElemenT > > {
-  typedef concur::ScmpQueue< ElemenT > container_type;
+template < typename ElemenT, typename NodePolicy >
+struct ContainerTraits< concur::ScmpQueue< ElemenT, NodePolicy > > {
+  typedef concur::ScmpQueue< ElemenT, NodePolicy > container_type;
   
   static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec< container_type >; }
@@ -67,9 +69,9 @@ struct ContainerTraits< concur::ScmpQueue< ElemenT > > {
 
 //--------------------------------------------------------------------------------
 
-template < typename ElemenT, std::size_t Alignment >
-struct ContainerTraits< concur::ScmpRingArray< ElemenT, Alignment > > {
-  typedef concur::ScmpRingArray< ElemenT, Alignment > container_type;
+template < typename ElemenT, std::size_t Alignment, typename IndexPolicy, typename StoragePolicy >
+struct ContainerTraits< concur::ScmpRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > > {
+  typedef concur::ScmpRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > container_type;
   
   static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec< container_type >; }
@@ -82,9 +84,24 @@ struct ContainerTraits< concur::ScmpRingArray< ElemenT, Alignment > > {
 
 //--------------------------------------------------------------------------------
 
-template < typename ElemenT, std::size_t Alignment >
-struct ContainerTraits< concur::ScspRingArray< ElemenT, Alignment > > {
-  typedef concur::ScspRingArray< ElemenT, Alignment > container_type;
+template < typename ElemenT, std::size_t Alignment, typename IndexPolicy, typename StoragePolicy >
+struct ContainerTraits< concur::ScspRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > > {
+  typedef concur::ScspRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > container_type;
+  
+  static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
+  static SceneDesc::thread_func_type cons( ) { return &cexec< container_type >; }
+  
+  static void apply_to_scene( SceneDesc& desc ) {
+    desc.prod_desc.thread_count = ( std::min )( 1u, desc.prod_desc.thread_count );
+    desc.cons_desc.thread_count = ( std::min )( 1u, desc.cons_desc.thread_count );
+  }
+};
+
+//--------------------------------------------------------------------------------
+
+template < typename ElemenT, std::size_t Alignment, typename IndexPolicy, typename StoragePolicy >
+struct ContainerTraits< concur::ScspCachedRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > > {
+  typedef concur::ScspCachedRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > container_type;
   
   static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec< container_type >; }
@@ -97,9 +114,9 @@ struct ContainerTraits< concur::ScspRingArray< ElemenT, Alignment > > {
 
 //--------------------------------------------------------------------------------
 
-template < typename ElemenT, std::size_t Alignment >
-struct ContainerTraits< concur::ScspPtrRingArray< ElemenT, Alignment > > {
-  typedef concur::ScspPtrRingArray< ElemenT, Alignment > container_type;
+template < typename ElemenT, std::size_t Alignment, typename IndexPolicy, typename StoragePolicy >
+struct ContainerTraits< concur::ScspPtrRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > > {
+  typedef concur::ScspPtrRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > container_type;
   
   static SceneDesc::thread_func_type prod( ) { return &pexec_ptr< container_type >; }
   static SceneDesc::thread_func_type cons( ) { return &cexec_ptr< container_type >; }
@@ -110,6 +127,21 @@ struct ContainerTraits< concur::ScspPtrRingArray< ElemenT, Alignment > > {
   }
 };
 
+//--------------------------------------------------------------------------------
+
+template < typename ContainerT, unsigned SpinCount >
+struct ContainerTraits< concur::WaitableContainer< ContainerT, SpinCount > > {
+  typedef concur::WaitableContainer< ContainerT, SpinCount > container_type;
+  
+  static SceneDesc::thread_func_type prod( ) { return &pexec_stamp< container_type >; }
+  static SceneDesc::thread_func_type cons( ) { return &cexec_wait< container_type >; }
+  
+  static void apply_to_scene( SceneDesc& desc ) {
+    ContainerTraits< ContainerT >::apply_to_scene( desc );
+    desc.measure_latency = true;
+  }
+};
+
 //--------------------------------------------------------------------------------
 } // namespace scene_1
 //--------------------------------------------------------------------------------
@@ -132,6 +164,8 @@ typedef concur::CondvarQueue< element_type, false >           condvar_queue_type
 typedef concur::CondvarQueue< element_type, true >            condvar_queue_limited_type;
 typedef concur::CondvarRingArray< element_type >              condvar_ring_attay_type;
 typedef concur::ScmpQueue< element_type >                     scmp_queue_type;
+typedef concur::ScmpQueue< element_type,
+          concur::utils::recycled_nodes< > >                   scmp_queue_recycled_type;
 typedef concur::ScmpRingArray< element_type, 1 >              scmp_ring_array_type;
 typedef concur::ScmpRingArray< element_type, 64 >             scmp_ring_array_a64_type;
 typedef concur::ScmpRingArray< element_type, 128 >            scmp_ring_array_a128_type;
@@ -139,6 +173,28 @@ typedef concur::ScspRingArray< element_type, 1 >              scsp_ring_array_no
 typedef concur::ScspRingArray< element_type, 64 >             scsp_ring_array_a64_type;
 typedef concur::ScspPtrRingArray< element_type, 1 >           scsp_ptr_ring_array_noalg_type;
 typedef concur::ScspPtrRingArray< element_type, 64 >          scsp_ptr_ring_array_a64_type;
+typedef concur::ScspCachedRingArray< element_type, 64 >       scsp_cached_ring_array_type;
+typedef concur::WaitableContainer< scmp_ring_array_a64_type > waitable_scmp_ring_array_type;
+typedef concur::WaitableContainer< scmp_queue_type >          waitable_scmp_queue_type;
+
+typedef concur::utils::pow2_index                                                 pow2_index;
+typedef concur::RingArray< element_type, std::mutex, pow2_index >                 mt_ring_array_std_pow2_type;
+typedef concur::ScmpRingArray< element_type, 64, pow2_index >                     scmp_ring_array_a64_pow2_type;
+typedef concur::ScspRingArray< element_type, 64, pow2_index >                     scsp_ring_array_a64_pow2_type;
+typedef concur::ScspPtrRingArray< element_type, 64, pow2_index >                  scsp_ptr_ring_array_a64_pow2_type;
+
+typedef concur::utils::CircularBuffer< element_type >                             circular_buffer_type;
+typedef concur::Queue< element_type, std::mutex, false, circular_buffer_type >    mt_queue_std_circular_type;
+typedef concur::CondvarQueue< element_type, false, circular_buffer_type >         condvar_queue_circular_type;
+
+// container capacity rounded up to a power of two
+inline unsigned pow2_capacity( )
+{
+  unsigned capacity = 1;
+  while( capacity < get_config( ).container_capacity )
+    capacity <<= 1;
+  return capacity;
+}
 
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE( CASE_mt_queue_std )
@@ -229,6 +285,14 @@ BOOST_AUTO_TEST_CASE( CASE_scmp_queue )
 //--------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmp_queue_recycled )
+{
+  scmp_queue_recycled_type container;
+  run_exchange_test( container, "scmp_queue_recycled" );
+} // CASE_scmp_queue_recycled
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE( CASE_scmp_ring_array )
 {
   scmp_ring_array_type container;
@@ -304,6 +368,85 @@ BOOST_AUTO_TEST_CASE( CASE_scsp_ptr_ring_array_a64 )
   run_exchange_test( container, "scsp_ptr_ring_array_a64" );
 } // CASE_scsp_ptr_ring_array_a64
 //--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_cached_ring_array )
+{
+  scsp_cached_ring_array_type container;
+  container.init( get_config( ).container_capacity );
+  run_exchange_test( container, "scsp_cached_ring_array" );
+} // CASE_scsp_cached_ring_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_waitable_scmp_ring_array )
+{
+  waitable_scmp_ring_array_type container;
+  container.init( get_config( ).container_capacity );
+  run_exchange_test( container, "waitable_scmp_ring_array" );
+} // CASE_waitable_scmp_ring_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_waitable_scmp_queue )
+{
+  waitable_scmp_queue_type container;
+  run_exchange_test( container, "waitable_scmp_queue" );
+} // CASE_waitable_scmp_queue
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_mt_ring_array_std_pow2 )
+{
+  mt_ring_array_std_pow2_type container;
+  container.init( pow2_capacity( ) );
+  run_exchange_test( container, "mt_ring_array_std_pow2" );
+} // CASE_mt_ring_array_std_pow2
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmp_ring_array_a64_pow2 )
+{
+  scmp_ring_array_a64_pow2_type container;
+  container.init( pow2_capacity( ) );
+  run_exchange_test( container, "scmp_ring_array_a64_pow2" );
+} // CASE_scmp_ring_array_a64_pow2
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_ring_array_a64_pow2 )
+{
+  scsp_ring_array_a64_pow2_type container;
+  container.init( pow2_capacity( ) );
+  run_exchange_test( container, "scsp_ring_array_a64_pow2" );
+} // CASE_scsp_ring_array_a64_pow2
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_ptr_ring_array_a64_pow2 )
+{
+  scsp_ptr_ring_array_a64_pow2_type container;
+  container.init( pow2_capacity( ) );
+  run_exchange_test( container, "scsp_ptr_ring_array_a64_pow2" );
+} // CASE_scsp_ptr_ring_array_a64_pow2
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_mt_queue_std_circular )
+{
+  mt_queue_std_circular_type container;
+  container.init( get_config( ).container_capacity );
+  run_exchange_test( container, "mt_queue_std_circular" );
+} // CASE_mt_queue_std_circular
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_condvar_queue_circular )
+{
+  condvar_queue_circular_type container;
+  run_exchange_test( container, "condvar_queue_circular" );
+} // CASE_condvar_queue_circular
+//--------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END( ) // SUITE_exchange_logic
@@ -21,6 +21,53 @@ typedef Collectors< element_type >      collectors_type;
 
 //--------------------------------------------------------------------------------
 
+// Push times by operation number and push-to-pop latencies by consumer, for
+// the containers whose consumers wait ('SceneDesc::measure_latency'). The push
+// time is stored before the push, so the container orders it before the pop.
+class LatencyProbe
+{
+public:
+  // nothing to measure
+  void reset( )
+  {
+    std::vector< counter_type >( ).swap( push_times_ );
+    std::vector< std::vector< counter_type > >( ).swap( latencies_ );
+  }
+
+  void reset( counter_type operations, unsigned consumer_count )
+  {
+    push_times_.assign( static_cast< std::size_t >( operations + 1 ), 0 );
+    latencies_.assign( consumer_count, std::vector< counter_type >( ) );
+    for( std::vector< counter_type >& l : latencies_ )
+      l.reserve( static_cast< std::size_t >( operations ) );
+  }
+
+  inline void pushing( counter_type num ) { push_times_[ num ] = now( ).count( ); }
+  inline void popped( unsigned i, counter_type num ) { latencies_[ i ].push_back( now( ).count( ) - push_times_[ num ] ); }
+
+  // sorted, empty if nothing was measured
+  std::vector< counter_type > latencies( ) const
+  {
+    std::vector< counter_type > all;
+    for( const std::vector< counter_type >& l : latencies_ )
+      all.insert( all.end( ), l.begin( ), l.end( ) );
+    std::sort( all.begin( ), all.end( ) );
+    return all;
+  }
+
+private:
+  std::vector< counter_type >                 push_times_;
+  std::vector< std::vector< counter_type > >  latencies_;
+};
+
+inline LatencyProbe& latency_probe( )
+{
+  static LatencyProbe probe;
+  return probe;
+}
+
+//--------------------------------------------------------------------------------
+
 // default producer loop
 template < typename ContainerT >
 bool pexec( unsigned , void* , void* container_ptr, counter_type num )
@@ -41,6 +88,16 @@ bool cexec( unsigned i, void* arg, void* container_ptr, counter_type )
   return true;
 }
 
+// producer loop for waitable container, stamps the push time
+template < typename ContainerT >
+bool pexec_stamp( unsigned , void* , void* container_ptr, counter_type num )
+{
+  latency_probe( ).pushing( num );
+  while( !static_cast< ContainerT* >( container_ptr )->push( num ) )
+    ;
+  return true;
+}
+
 // consumer loop for waitable container
 template < typename ContainerT >
 bool cexec_wait( unsigned i, void* arg, void* container_ptr, counter_type )
@@ -48,6 +105,7 @@ bool cexec_wait( unsigned i, void* arg, void* container_ptr, counter_type )
   element_type dst{ };
   while( !static_cast< ContainerT* >( container_ptr )->pop( dst, std::chrono::milliseconds( 100 ) ) )
     ;
+  latency_probe( ).popped( i, dst );
   static_cast< collectors_type* >( arg )->push( i, dst );
   return true;
 }
@@ -151,9 +209,34 @@ void run_exchange_test( ContainerT& container, const char* test_name = "" )
     
     CpuTimes times;
     
-    run_scene( &container, desc, &times );
+    if( desc.measure_latency )
+      latency_probe( ).reset( desc.operations, desc.cons_desc.thread_count );
+    else
+      latency_probe( ).reset( );
+    uint64_t allocations = 0;
+    int64_t  switches    = 0;
+    {
+      AllocationCounting counting;
+      allocations = allocation_count( );
+      switches    = context_switch_count( );
+      run_scene( &container, desc, &times );
+      switches    = context_switch_count( ) - switches;
+      allocations = allocation_count( ) - allocations;
+    }
     
     BOOST_TEST_MESSAGE( "test '" << test_name << "' (" << r << ") took: " << times.str( ) );
+    BOOST_TEST_MESSAGE( "test '" << test_name << "' (" << r << ") "
+                        << ( times.wall ? desc.operations * 1000.0 / times.wall : 0.0 ) << " Mops/s; "
+                        << allocations << " allocations; "
+                        << ( desc.operations ? double( switches ) / desc.operations : 0.0 ) << " context switches/op" );
+    
+    const std::vector< counter_type > latencies = latency_probe( ).latencies( );
+    if( !latencies.empty( ) ) {
+      BOOST_TEST_MESSAGE( "test '" << test_name << "' (" << r << ") push to pop latency, us:"
+                          << " p50 " << ( latencies[ latencies.size( ) / 2 ] / 1000.0 )
+                          << "; p99 " << ( latencies[ latencies.size( ) * 99 / 100 ] / 1000.0 )
+                          << "; max " << ( latencies.back( ) / 1000.0 ) );
+    }
     
     BOOST_CHECK( dests.check( 1, cfg.operation_count + 1 ) );
   }
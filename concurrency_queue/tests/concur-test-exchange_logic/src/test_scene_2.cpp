@@ -0,0 +1,111 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+//--------------------------------------------------------------------------------
+# include "test_scene_2.h"
+//--------------------------------------------------------------------------------
+# include <condvar_queue.h>
+# include <scmp_queue.h>
+# include <scmp_ring_array.h>
+# include <scsp_ring_array.h>
+# include <waitable_container.h>
+//--------------------------------------------------------------------------------
+namespace scene_2 {
+//--------------------------------------------------------------------------------
+
+template < typename ElemenT, std::size_t Alignment, typename IndexPolicy, typename StoragePolicy >
+struct ContainerTraits< concur::ScspRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > > {
+  typedef concur::ScspRingArray< ElemenT, Alignment, IndexPolicy, StoragePolicy > container_type;
+
+  static SceneDesc::thread_func_type prod( ) { return &pexec< container_type >; }
+  static SceneDesc::thread_func_type cons( ) { return &cexec_spin< container_type >; }
+};
+
+//--------------------------------------------------------------------------------
+} // namespace scene_2
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_wakeup )
+//--------------------------------------------------------------------------------
+
+using namespace scene_2;
+
+//--------------------------------------------------------------------------------
+
+typedef concur::ScspRingArray< element_type, 64 >                     scsp_ring_array_type;
+typedef concur::CondvarQueue< element_type, false >                   condvar_queue_type;
+typedef concur::WaitableContainer< scsp_ring_array_type >             waitable_scsp_ring_array_type;
+typedef concur::WaitableContainer<
+          concur::ScmpRingArray< element_type, 64 > >                 waitable_scmp_ring_array_type;
+typedef concur::WaitableContainer<
+          concur::ScmpQueue< element_type > >                         waitable_scmp_queue_type;
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_waitable_basic )
+{
+  waitable_scsp_ring_array_type container;
+  container.init( 2 );
+
+  element_type dst = 0;
+  BOOST_CHECK( !container.pop( dst, std::chrono::milliseconds( 1 ) ) );
+
+  BOOST_CHECK( container.push( 1, std::chrono::milliseconds( 1 ) ) );
+  BOOST_CHECK( container.push( 2 ) );
+  BOOST_CHECK( !container.push( 3, std::chrono::milliseconds( 1 ) ) );
+
+  BOOST_CHECK( container.pop( dst, std::chrono::milliseconds( 1 ) ) && ( dst == 1 ) );
+  BOOST_CHECK( container.pop( dst, 1000u ) && ( dst == 2 ) );
+  BOOST_CHECK( !container.pop( dst ) );
+
+  BOOST_CHECK( container.consumer_waiters( ) == 0 );
+  BOOST_CHECK( container.producer_waiters( ) == 0 );
+} // CASE_waitable_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_wakeup_scsp_ring_array_spin )
+{
+  scsp_ring_array_type container;
+  container.init( get_config( ).container_capacity );
+  run_wakeup_test( container, "scsp_ring_array_spin" );
+} // CASE_wakeup_scsp_ring_array_spin
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_wakeup_condvar_queue )
+{
+  condvar_queue_type container;
+  run_wakeup_test( container, "condvar_queue" );
+} // CASE_wakeup_condvar_queue
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_wakeup_waitable_scsp_ring_array )
+{
+  waitable_scsp_ring_array_type container;
+  container.init( get_config( ).container_capacity );
+  run_wakeup_test( container, "waitable_scsp_ring_array" );
+} // CASE_wakeup_waitable_scsp_ring_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_wakeup_waitable_scmp_ring_array )
+{
+  waitable_scmp_ring_array_type container;
+  container.init( get_config( ).container_capacity );
+  run_wakeup_test( container, "waitable_scmp_ring_array" );
+} // CASE_wakeup_waitable_scmp_ring_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_wakeup_waitable_scmp_queue )
+{
+  waitable_scmp_queue_type container;
+  run_wakeup_test( container, "waitable_scmp_queue" );
+} // CASE_wakeup_waitable_scmp_queue
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_wakeup
+//--------------------------------------------------------------------------------
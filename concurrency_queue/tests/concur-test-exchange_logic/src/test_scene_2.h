@@ -0,0 +1,113 @@
+# ifndef _TEST_SCENE_2_H_
+# define _TEST_SCENE_2_H_
+//--------------------------------------------------------------------------------
+# include <boost/test/test_tools.hpp>
+//--------------------------------------------------------------------------------
+# include "test_helpers.h"
+//--------------------------------------------------------------------------------
+namespace scene_2 {
+//--------------------------------------------------------------------------------
+//
+// Low traffic: a single producer pushes its timestamp once per 'INTERVAL', a
+// single consumer waits for it and records the wake latency. The process CPU
+// time over the run shows how much the consumer burns while idle.
+//
+//--------------------------------------------------------------------------------
+
+typedef counter_type                  element_type;
+typedef std::vector< counter_type >   latencies_type;
+
+const counter_type                MESSAGE_COUNT = 500;
+const std::chrono::microseconds   INTERVAL( 1000 );
+
+//--------------------------------------------------------------------------------
+
+// producer loop: sleep, then push the current time
+template < typename ContainerT >
+bool pexec( unsigned , void* , void* container_ptr, counter_type )
+{
+  std::this_thread::sleep_for( INTERVAL );
+  while( !static_cast< ContainerT* >( container_ptr )->push( now( ).count( ) ) )
+    ;
+  return true;
+}
+
+// consumer loop for a spinning container
+template < typename ContainerT >
+bool cexec_spin( unsigned , void* arg, void* container_ptr, counter_type )
+{
+  element_type ts{ };
+  while( !static_cast< ContainerT* >( container_ptr )->pop( ts ) )
+    ;
+  static_cast< latencies_type* >( arg )->push_back( now( ).count( ) - ts );
+  return true;
+}
+
+// consumer loop for a waitable container
+template < typename ContainerT >
+bool cexec_wait( unsigned , void* arg, void* container_ptr, counter_type )
+{
+  element_type ts{ };
+  while( !static_cast< ContainerT* >( container_ptr )->pop( ts, std::chrono::milliseconds( 100 ) ) )
+    ;
+  static_cast< latencies_type* >( arg )->push_back( now( ).count( ) - ts );
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+
+template < typename ContainerT >
+struct ContainerTraits
+{
+  static SceneDesc::thread_func_type prod( ) { return &pexec< ContainerT >; }
+  static SceneDesc::thread_func_type cons( ) { return &cexec_wait< ContainerT >; }
+};
+
+//--------------------------------------------------------------------------------
+
+template < typename ContainerT >
+void run_wakeup_test( ContainerT& container, const char* test_name = "" )
+{
+  typedef ContainerTraits< ContainerT > traits;
+
+  const TestConfig& cfg = get_config( );
+
+  for( unsigned r( 0 ); r < cfg.repeat_count; ++r ) {
+    latencies_type latencies;
+    latencies.reserve( MESSAGE_COUNT );
+
+    SceneDesc desc;
+    desc.operations                 = MESSAGE_COUNT;
+    desc.prod_desc.function         = traits::prod( );
+    desc.prod_desc.thread_count     = 1;
+    desc.prod_desc.thread_affinity  = cfg.prod_thread_affinity;
+    desc.cons_desc.function         = traits::cons( );
+    desc.cons_desc.arg              = &latencies;
+    desc.cons_desc.thread_count     = 1;
+    desc.cons_desc.thread_affinity  = cfg.cons_thread_affinity;
+
+    CpuTimes times;
+    run_scene( &container, desc, &times );
+
+    BOOST_REQUIRE( latencies.size( ) == static_cast< std::size_t >( MESSAGE_COUNT ) );
+    std::sort( latencies.begin( ), latencies.end( ) );
+
+    counter_type sum = 0;
+    for( counter_type l : latencies ) sum += l;
+
+    const double cpu_load = times.wall ? double( times.user + times.system ) / times.wall : 0.0;
+
+    BOOST_TEST_MESSAGE( "test '" << test_name << "' (" << r << ") took: " << times.str( ) );
+    BOOST_TEST_MESSAGE( "test '" << test_name << "' (" << r << ") wake latency, us:"
+                        << " avg " << ( sum / MESSAGE_COUNT / 1000.0 )
+                        << "; p50 " << ( latencies[ latencies.size( ) / 2 ] / 1000.0 )
+                        << "; p99 " << ( latencies[ latencies.size( ) * 99 / 100 ] / 1000.0 )
+                        << "; max " << ( latencies.back( ) / 1000.0 )
+                        << "; cpu load " << ( cpu_load * 100.0 ) << " %" );
+  }
+}
+
+//--------------------------------------------------------------------------------
+} // namespace scene_2
+//--------------------------------------------------------------------------------
+# endif // _TEST_SCENE_2_H_
@@ -0,0 +1,106 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+//--------------------------------------------------------------------------------
+# include "test_scene_3.h"
+//--------------------------------------------------------------------------------
+# include <ring_bar.h>
+# include <unordered_ring_bar.h>
+//--------------------------------------------------------------------------------
+namespace scene_3 {
+//--------------------------------------------------------------------------------
+
+template < typename Type, std::size_t Alignment, typename IndexPolicy, typename StoragePolicy >
+struct Watchdog< concur::UnorderedRingBar< Type, Alignment, IndexPolicy, StoragePolicy > >
+{
+  typedef concur::UnorderedRingBar< Type, Alignment, IndexPolicy, StoragePolicy > bar_type;
+
+  static bool available( ) { return true; }
+  static duration_type oldest_hold( bar_type& bar ) { return bar.oldest_hold( ); }
+};
+
+//--------------------------------------------------------------------------------
+} // namespace scene_3
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_stall )
+//--------------------------------------------------------------------------------
+
+using namespace scene_3;
+
+//--------------------------------------------------------------------------------
+
+typedef concur::RingBar< element_type, 64 >           ring_bar_type;
+typedef concur::UnorderedRingBar< element_type, 64 >  unordered_ring_bar_type;
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_unordered_ring_bar_basic )
+{
+  unordered_ring_bar_type bar;
+  bar.init( 3 );
+  BOOST_CHECK( bar.oldest_hold( ) == duration_type::zero( ) );
+
+  element_type* a = bar.visitor_fetch( );
+  element_type* b = bar.visitor_fetch( );
+  element_type* c = bar.visitor_fetch( );
+  BOOST_REQUIRE( a && b && c );
+  BOOST_CHECK( !bar.visitor_fetch( ) );
+
+  // 'a' is stuck, the master passes it by
+  *a = 1; *b = 2; *c = 3;
+  bar.visitor_release( c );
+  bar.visitor_release( b );
+
+  element_type* ptr = bar.master_fetch( );
+  BOOST_REQUIRE( ptr && *ptr == 3 );
+  bar.master_release( ptr );
+  ptr = bar.master_fetch( );
+  BOOST_REQUIRE( ptr && *ptr == 2 );
+  bar.master_release( ptr );
+  BOOST_CHECK( !bar.master_fetch( ) );
+
+  // the passed elements are fetched again while 'a' is still held
+  std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+  element_type* d = bar.visitor_fetch( );
+  element_type* e = bar.visitor_fetch( );
+  BOOST_REQUIRE( d && e );
+  BOOST_CHECK( !bar.visitor_fetch( ) );
+  BOOST_CHECK( bar.oldest_hold( ) >= std::chrono::milliseconds( 2 ) );
+
+  bar.visitor_release( a );
+  bar.visitor_release( d );
+  bar.visitor_release( e );
+  ptr = bar.master_fetch( );
+  BOOST_CHECK( ptr == a );
+  bar.master_release( ptr );
+  BOOST_CHECK( bar.oldest_hold( ) == duration_type::zero( ) );
+
+  bar.master_skip_all( );
+  BOOST_CHECK( !bar.master_fetch( ) );
+  for( unsigned i( 0 ); i < 3; ++i )
+    BOOST_CHECK( bar.visitor_fetch( ) );
+} // CASE_unordered_ring_bar_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_stall_ring_bar )
+{
+  ring_bar_type bar;
+  bar.init( get_config( ).container_capacity );
+  run_stall_test( bar, "ring_bar" );
+} // CASE_stall_ring_bar
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_stall_unordered_ring_bar )
+{
+  unordered_ring_bar_type bar;
+  bar.init( get_config( ).container_capacity );
+  run_stall_test( bar, "unordered_ring_bar" );
+} // CASE_stall_unordered_ring_bar
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_stall
+//--------------------------------------------------------------------------------
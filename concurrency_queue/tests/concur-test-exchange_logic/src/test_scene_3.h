@@ -0,0 +1,137 @@
+# ifndef _TEST_SCENE_3_H_
+# define _TEST_SCENE_3_H_
+//--------------------------------------------------------------------------------
+# include <boost/test/test_tools.hpp>
+//--------------------------------------------------------------------------------
+# include "test_helpers.h"
+//--------------------------------------------------------------------------------
+namespace scene_3 {
+//--------------------------------------------------------------------------------
+//
+// A stalled visitor: visitors fetch an element of a bar, write their number and
+// a sequence number into it and release it, a master takes them. Every visitor
+// does an equal share of the operations, but the first one holds its first
+// element and every 'STALL_EVERY'th after it for 'STALL' before release. The
+// others start once the first element is fetched. The master rate over the
+// elements of the other visitors shows how much the stalls hold them up, a
+// watchdog thread samples the oldest hold where the bar can tell it.
+//
+//--------------------------------------------------------------------------------
+
+typedef counter_type                  element_type;
+
+const counter_type                STALL_EVERY = 1000;
+const std::chrono::microseconds   STALL( 2000 );
+const std::chrono::microseconds   WATCH_INTERVAL( 500 );
+
+const unsigned                    VISITOR_SHIFT = 48;
+const counter_type                SEQ_MASK      = ( counter_type( 1 ) << VISITOR_SHIFT ) - 1;
+
+//--------------------------------------------------------------------------------
+
+template < typename BarT >
+struct Watchdog
+{
+  static bool available( ) { return false; }
+  static duration_type oldest_hold( BarT& ) { return duration_type::zero( ); }
+};
+
+//--------------------------------------------------------------------------------
+
+template < typename BarT >
+void run_stall_test( BarT& bar, const char* test_name = "" )
+{
+  typedef Watchdog< BarT > watchdog;
+
+  const TestConfig& cfg = get_config( );
+  const unsigned      visitor_count = ( std::max )( cfg.prod_thread_count, 2u );
+  const counter_type  share         = cfg.operation_count / visitor_count;
+  const counter_type  total         = share * visitor_count;
+
+  std::atomic< bool > started( false );
+  std::atomic< bool > done( false );
+  std::vector< counter_type > received( visitor_count, 0 );
+  std::vector< counter_type > sums( visitor_count, 0 );
+
+  duration_type max_hold( 0 );
+  duration_type others_dur( 0 );    // till the last element of the running visitors
+  duration_type master_dur( 0 );
+  {
+    ThreadHolder visitors;
+    visitors.initialize( visitor_count, [ & ]( unsigned i ) {
+      while( i && !started.load( ) )
+        std::this_thread::yield( );
+      for( counter_type seq( 1 ); seq <= share; ++seq ) {
+        element_type* ptr = nullptr;
+        while( !( ptr = bar.visitor_fetch( ) ) )
+          std::this_thread::yield( );
+        *ptr = ( counter_type( i ) << VISITOR_SHIFT ) | seq;
+        if( !i && ( seq % STALL_EVERY ) == 1 ) {
+          started.store( true );
+          std::this_thread::sleep_for( STALL );
+        }
+        bar.visitor_release( ptr );
+      }
+    }, cfg.prod_thread_affinity );
+
+    ThreadHolder master;
+    master.initialize( 1, [ & ]( unsigned ) {
+      const duration_type start = now( );
+      counter_type others = 0;
+      for( counter_type n( 0 ); n < total; ) {
+        element_type* ptr = bar.master_fetch( );
+        if( !ptr ) {
+          std::this_thread::yield( );
+          continue;
+        }
+        const unsigned visitor = static_cast< unsigned >( *ptr >> VISITOR_SHIFT );
+        ++received[ visitor ];
+        sums[ visitor ] += *ptr & SEQ_MASK;
+        bar.master_release( ptr );
+        ++n;
+
+        if( visitor && ( ++others == total - share ) )
+          others_dur = now( ) - start;
+      }
+      done.store( true );
+    }, cfg.cons_thread_affinity );
+
+    ThreadHolder watcher;
+    if( watchdog::available( ) ) {
+      watcher.initialize( 1, [ & ]( unsigned ) {
+        while( !done.load( ) ) {
+          max_hold = ( std::max )( max_hold, watchdog::oldest_hold( bar ) );
+          std::this_thread::sleep_for( WATCH_INTERVAL );
+        }
+      } );
+    }
+
+    visitors.launch( );
+    master.launch( );
+    watcher.launch( );
+
+    visitors.stop( );
+    master_dur = master.stop( );
+  }
+
+  for( unsigned i( 0 ); i < visitor_count; ++i ) {
+    BOOST_CHECK( received[ i ] == share );
+    BOOST_CHECK( sums[ i ] == share * ( share + 1 ) / 2 );
+  }
+
+  typedef std::chrono::duration< double > sec_type;
+  const double others_sec = std::chrono::duration_cast< sec_type >( others_dur ).count( );
+  const double master_sec = std::chrono::duration_cast< sec_type >( master_dur ).count( );
+  BOOST_TEST_MESSAGE( "test '" << test_name << "' (" << visitor_count << " visitors, "
+                      << ( ( share + STALL_EVERY - 1 ) / STALL_EVERY ) << " stalls x " << STALL.count( ) << " us): master "
+                      << ( others_sec > 0.0 ? ( total - share ) / others_sec / 1000000.0 : 0.0 )
+                      << " Mops/s over running visitors; took " << master_sec << " s" );
+  if( watchdog::available( ) )
+    BOOST_TEST_MESSAGE( "test '" << test_name << "' oldest hold seen by watchdog: "
+                        << std::chrono::duration_cast< std::chrono::microseconds >( max_hold ).count( ) << " us" );
+}
+
+//--------------------------------------------------------------------------------
+} // namespace scene_3
+//--------------------------------------------------------------------------------
+# endif // _TEST_SCENE_3_H_
@@ -22,7 +22,20 @@ INCLUDEPATH *= ../../../
 SOURCES += \
     ../src/main.cpp \
     ../src/thread_master.cpp \
-    ../src/test_scmp_ring_collection.cpp
+    ../src/test_scmp_ring_collection.cpp \
+    ../src/test_scmp_ring_array_bulk.cpp \
+    ../src/test_scmp_ring_array_claim.cpp \
+    ../src/test_scsp_ring_index.cpp \
+    ../src/test_scsp_cached_ring_array.cpp \
+    ../src/test_scmp_queue_nodes.cpp \
+    ../src/test_scmp_queue_drain.cpp \
+    ../src/test_ring_storage.cpp \
+    ../src/test_ring_emplace.cpp \
+    ../src/test_container_grab.cpp \
+    ../src/test_queue_swap.cpp \
+    ../src/test_spin_lock.cpp \
+    ../src/test_circular_buffer.cpp \
+    ../src/test_condvar_queue.cpp
 
 HEADERS += \
     ../src/test_config.h \
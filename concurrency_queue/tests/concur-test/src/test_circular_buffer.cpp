@@ -0,0 +1,153 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <cstdint>
+# include <memory>
+# include <stdexcept>
+//--------------------------------------------------------------------------------
+# include <mt_containers.h>
+# include <utils/circular_buffer.h>
+# include <utils/queue_wrap.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_circular_buffer )
+//--------------------------------------------------------------------------------
+
+typedef std::shared_ptr< int >  item_type;  // counts its copies alive
+
+// its copy throws when told to; no move, so the buffer has to copy it
+struct Fragile
+{
+  static bool fail;
+
+  int value;
+
+  Fragile( int v ) : value( v ) { }
+  Fragile( const Fragile& x ) : value( x.value )
+  {
+    if( fail )
+      throw std::runtime_error( "copy failed" );
+  }
+};
+
+bool Fragile::fail = false;
+
+struct ALIGNAS( 64 ) Wide
+{
+  int value;
+};
+
+// counts the calls of its 'clear'
+struct ClearCounting : concur::utils::CircularBuffer< int, 4 >
+{
+  static unsigned clear_count;
+
+  void clear( )
+  {
+    ++clear_count;
+    concur::utils::CircularBuffer< int, 4 >::clear( );
+  }
+};
+
+unsigned ClearCounting::clear_count = 0;
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_circular_buffer )
+{
+  const item_type item = std::make_shared< int >( 0 );
+  {
+    concur::utils::CircularBuffer< item_type, 4 > buffer;
+    BOOST_CHECK( buffer.empty( ) && buffer.capacity( ) == 0 );
+
+    // wrapped around before growing, so the growth has to unwrap it
+    for( int i( 0 ); i < 3; ++i )
+      buffer.emplace( item );
+    buffer.pop( );
+    buffer.pop( );
+    for( int i( 0 ); i < 5; ++i )
+      buffer.push( item );
+    BOOST_CHECK( buffer.size( ) == 6 && buffer.capacity( ) == 8 );
+    BOOST_CHECK( item.use_count( ) == 7 );
+
+    // drained, it keeps the capacity
+    while( !buffer.empty( ) ) {
+      BOOST_CHECK( buffer.front( ) == item );
+      buffer.pop( );
+    }
+    BOOST_CHECK( buffer.capacity( ) == 8 && item.use_count( ) == 1 );
+
+    buffer.reserve( 9 );
+    BOOST_CHECK( buffer.capacity( ) == 16 );
+
+    concur::utils::CircularBuffer< item_type, 4 > other;
+    other.push( item );
+    buffer.swap( other );
+    BOOST_CHECK( buffer.size( ) == 1 && other.capacity( ) == 16 );
+  }
+  BOOST_CHECK( item.use_count( ) == 1 );
+
+  // the order survives growing in the middle of the traffic
+  concur::Queue< int, std::mutex, false, concur::utils::CircularBuffer< int, 2 > > queue;
+  int next_pop = 0;
+  for( int i( 0 ); i < 100; ++i ) {
+    BOOST_CHECK( queue.push( i ) );
+    int dst = -1;
+    if( i % 3 == 0 )
+      BOOST_CHECK( queue.pop( dst ) && dst == next_pop++ );
+  }
+  for( int dst( -1 ); queue.pop( dst ); )
+    BOOST_CHECK( dst == next_pop++ );
+  BOOST_CHECK( next_pop == 100 );
+
+  // a storage with 'clear' keeps its memory, std::queue gets swapped out
+  concur::utils::Queue< int, false, ClearCounting > counting;
+  concur::utils::Queue< int >                       plain;
+  for( int i( 0 ); i < 10; ++i ) {
+    counting.push( i );
+    plain.push( i );
+  }
+  counting.clear( );
+  plain.clear( );
+  BOOST_CHECK( ClearCounting::clear_count == 1 && counting.size( ) == 0 && plain.size( ) == 0 );
+} // CASE_circular_buffer
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_circular_buffer_growth )
+{
+  // the pushed element lives in the buffer which is about to grow
+  concur::utils::CircularBuffer< item_type, 2 > buffer;
+  buffer.push( std::make_shared< int >( 1 ) );
+  buffer.push( std::make_shared< int >( 2 ) );
+  buffer.push( buffer.front( ) );
+  buffer.emplace( buffer.front( ) );
+  BOOST_CHECK( buffer.size( ) == 4 && buffer.capacity( ) == 4 );
+  int values[ 4 ] = { 0, 0, 0, 0 };
+  for( int& v : values ) {
+    v = *buffer.front( );
+    buffer.pop( );
+  }
+  BOOST_CHECK( values[ 0 ] == 1 && values[ 1 ] == 2 && values[ 2 ] == 1 && values[ 3 ] == 1 );
+
+  // a growth failing midway leaves the buffer as it was
+  concur::utils::CircularBuffer< Fragile, 2 > fragile;
+  fragile.emplace( 1 );
+  fragile.emplace( 2 );
+  Fragile::fail = true;
+  BOOST_CHECK_THROW( fragile.emplace( 3 ), std::runtime_error );
+  BOOST_CHECK_THROW( fragile.reserve( 8 ), std::runtime_error );
+  Fragile::fail = false;
+  BOOST_CHECK( fragile.size( ) == 2 && fragile.capacity( ) == 2 );
+  BOOST_CHECK( fragile.front( ).value == 1 );
+  fragile.emplace( 3 );
+  BOOST_CHECK( fragile.size( ) == 3 && fragile.capacity( ) == 4 );
+
+  concur::utils::CircularBuffer< Wide, 2 > wide;
+  for( int i( 0 ); i < 5; ++i )
+    wide.push( Wide{ i } );
+  BOOST_CHECK( reinterpret_cast< std::uintptr_t >( &wide.front( ) ) % 64 == 0 );
+} // CASE_circular_buffer_growth
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_circular_buffer
+//--------------------------------------------------------------------------------
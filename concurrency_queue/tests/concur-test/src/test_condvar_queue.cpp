@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <atomic>
+# include <chrono>
+# include <thread>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <condvar_queue.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_condvar_queue )
+//--------------------------------------------------------------------------------
+
+const unsigned CONSUMER_COUNT = 4;
+
+// parks the consumers, then wakes them all with one bulk push
+template < typename ContainerT >
+void check_bulk_wakeup( ContainerT& cont )
+{
+  std::atomic< unsigned > received( 0 );
+  std::atomic< int >      sum( 0 );
+  {
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.count = CONSUMER_COUNT;
+    thread_cfg.func  = [ & ]( unsigned ) {
+      int dst = 0;
+      if( cont.pop( dst, std::chrono::seconds( 30 ) ) ) {
+        sum += dst;
+        ++received;
+      }
+    };
+    consumer.initialize( thread_cfg );
+    consumer.launch( );
+
+    while( cont.consumer_waiters( ) < CONSUMER_COUNT )
+      std::this_thread::yield( );
+
+    const std::vector< int > items = { 1, 2, 3, 4 };
+    BOOST_CHECK( cont.push_bulk( items.begin( ), items.end( ) ) == items.end( ) );
+  }
+  BOOST_CHECK( received == CONSUMER_COUNT && sum == 10 );
+  BOOST_CHECK( cont.consumer_waiters( ) == 0 && cont.size( ) == 0 );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_condvar_queue_bulk )
+{
+  concur::CondvarQueue< int > queue;
+  check_bulk_wakeup( queue );
+
+  concur::CondvarRingArray< int > ring;
+  ring.init( CONSUMER_COUNT );
+  check_bulk_wakeup( ring );
+
+  // a full ring takes as many as it has room for
+  const int items[ ] = { 1, 2, 3, 4, 5, 6 };
+  BOOST_CHECK( ring.push_bulk( items, items + 6 ) == items + CONSUMER_COUNT );
+  BOOST_CHECK( !ring.push( 7 ) && ring.size( ) == CONSUMER_COUNT );
+
+  // nobody waits, the pop times out
+  int dst = 0;
+  BOOST_CHECK( queue.push_bulk( items, items + 2 ) == items + 2 );
+  BOOST_CHECK( queue.pop( dst, std::chrono::milliseconds( 1 ) ) && dst == 1 );
+  BOOST_CHECK( queue.pop( dst, std::chrono::milliseconds( 1 ) ) && dst == 2 );
+  BOOST_CHECK( !queue.pop( dst, std::chrono::milliseconds( 1 ) ) );
+  BOOST_CHECK( queue.consumer_waiters( ) == 0 );
+} // CASE_condvar_queue_bulk
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_condvar_queue
+//--------------------------------------------------------------------------------
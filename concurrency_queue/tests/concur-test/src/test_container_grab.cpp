@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <chrono>
+# include <list>
+# include <thread>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <mt_containers.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_container_grab )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t                                                  item_type;
+typedef concur::Queue< item_type, std::mutex, true >              queue_type;
+typedef concur::RingArray< item_type >                            ring_array_type;
+typedef concur::RingArray< item_type, std::mutex,
+          concur::utils::pow2_index >                             ring_array_pow2_type;
+
+const std::size_t BATCH_SIZE = 1024;
+
+//--------------------------------------------------------------------------------
+
+// a capacity of 8, with the ring positions past its end on the second lap
+template < typename ContainerT >
+void check_ranges( )
+{
+  ContainerT container;
+  container.init( 8 );
+
+  std::vector< item_type > src;
+  for( item_type i( 0 ); i < 20; ++i )
+    src.push_back( i );
+
+  for( unsigned lap( 0 ); lap < 2; ++lap ) {
+    auto grab = container.grab( );
+    BOOST_CHECK( grab.push( item_type( 100 ) ) && grab.push( item_type( 101 ) ) );
+
+    // only six fit
+    auto rest = grab.push_range( src.begin( ), src.end( ) );
+    BOOST_CHECK( rest == src.begin( ) + 6 && grab.size( ) == 8 );
+    BOOST_CHECK( grab.push_range( rest, src.end( ) ) == rest );
+
+    item_type dst[ 3 ];
+    BOOST_CHECK( grab.pop_into( dst, 3 ) == 3 );
+    BOOST_CHECK( dst[ 0 ] == 100 && dst[ 1 ] == 101 && dst[ 2 ] == 0 );
+
+    // through the array end, from an input iterator
+    std::list< item_type > tail{ 50, 51 };
+    BOOST_CHECK( grab.push_range( tail.begin( ), tail.end( ) ) == tail.end( ) );
+
+    std::vector< item_type > out;
+    out.reserve( 16 );
+    const item_type* data = out.data( );
+    BOOST_CHECK( grab.swap_out( out ) == 7 );
+    BOOST_CHECK( ( out == std::vector< item_type >{ 1, 2, 3, 4, 5, 50, 51 } ) );
+    BOOST_CHECK( out.data( ) == data && grab.size( ) == 0 );
+
+    BOOST_CHECK( grab.pop_into( dst, 3 ) == 0 );
+    BOOST_CHECK( grab.swap_out( out ) == 0 && out.empty( ) );
+  }
+}
+
+//--------------------------------------------------------------------------------
+
+// A producer pushes 'op_count' items, a consumer drains them. 'Batched' ones
+// move 'BATCH_SIZE' items per lock, others take a lock per item.
+template < typename ContainerT, bool Batched >
+void run( const char* name )
+{
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+
+  ContainerT container;
+  container.init( cfg.container_capacity );
+
+  bool order_check = true;
+  std::chrono::steady_clock::time_point start_time;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      std::vector< item_type > batch;
+      batch.reserve( BATCH_SIZE );
+      for( uint64_t i = 0; i < op_count; ) {
+        if( Batched ) {
+          batch.clear( );
+          for( uint64_t end = ( std::min )( i + BATCH_SIZE, op_count ); i < end; ++i )
+            batch.push_back( i );
+          auto it = batch.begin( );
+          while( ( it = container.grab( ).push_range( it, batch.end( ) ) ) != batch.end( ) )
+            std::this_thread::yield( );
+        } else {
+          while( !container.grab( ).push( i ) )
+            std::this_thread::yield( );
+          ++i;
+        }
+      }
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      std::vector< item_type > batch;
+      for( uint64_t i = 0; i < op_count; ) {
+        if( Batched ) {
+          if( !container.grab( ).swap_out( batch ) )
+            std::this_thread::yield( );
+          for( item_type item : batch )
+            order_check &= ( item == i++ );
+        } else {
+          item_type item = 0;
+          while( !container.grab( ).pop( item ) )
+            std::this_thread::yield( );
+          order_check &= ( item == i++ );
+        }
+      }
+    };
+    consumer.initialize( thread_cfg );
+
+    start_time = std::chrono::steady_clock::now( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( order_check );
+  BOOST_TEST_MESSAGE( name << ( Batched ? ", push_range/swap_out: " : ", push/pop: " )
+                      << ( op_count ? double( duration.count( ) ) / op_count : 0.0 ) << " ns/item" );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_grab_ranges )
+{
+  check_ranges< queue_type >( );
+  check_ranges< ring_array_type >( );
+  check_ranges< ring_array_pow2_type >( );
+} // CASE_grab_ranges
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_grab_batches )
+{
+  run< queue_type, false >( "Queue" );
+  run< queue_type, true >( "Queue" );
+  run< ring_array_type, false >( "RingArray" );
+  run< ring_array_type, true >( "RingArray" );
+} // CASE_grab_batches
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_container_grab
+//--------------------------------------------------------------------------------
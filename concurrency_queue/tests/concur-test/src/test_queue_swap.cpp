@@ -0,0 +1,192 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <chrono>
+# include <memory>
+# include <mutex>
+# include <thread>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <mt_containers.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_queue_swap )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t                                item_type;
+typedef std::chrono::steady_clock               clock_type;
+
+//--------------------------------------------------------------------------------
+
+// how long the current thread has held TimedMutex
+struct HoldStats
+{
+  clock_type::duration  hold{ 0 };
+  uint64_t              locks = 0;
+};
+
+inline HoldStats& hold_stats( )
+{
+  static thread_local HoldStats stats;
+  return stats;
+}
+
+// std::mutex timing its holds; the clock calls are inside the lock, so it's
+// for the hold times only, not for the throughput
+class TimedMutex
+{
+public:
+  void lock( )
+  {
+    mtx_.lock( );
+    locked_at_ = clock_type::now( );
+  }
+
+  void unlock( )
+  {
+    HoldStats& stats = hold_stats( );
+    stats.hold += clock_type::now( ) - locked_at_;
+    ++stats.locks;
+    mtx_.unlock( );
+  }
+
+private:
+  std::mutex              mtx_;
+  clock_type::time_point  locked_at_;
+};
+
+//--------------------------------------------------------------------------------
+
+struct Result
+{
+  double    ns_per_item         = 0.0;
+  double    cons_hold_per_item  = 0.0;  // ns
+  double    cons_hold_per_lock  = 0.0;  // ns
+};
+
+// 'prod_count' producers push an item per lock, the consumer takes an item per
+// lock or, with 'Swap', swaps the whole queue for its drained buffer
+template < typename MutexT, bool Swap >
+Result run( unsigned prod_count )
+{
+  typedef concur::Queue< item_type, MutexT >        queue_type;
+  typedef typename queue_type::buffer_type          buffer_type;
+
+  const Config& cfg = get_config( );
+  const uint64_t per_prod = static_cast< uint64_t >( cfg.operation_count ) / prod_count;
+  const uint64_t total    = per_prod * prod_count;
+
+  queue_type queue;
+
+  std::unique_ptr< uint64_t[ ] > next( new uint64_t[ prod_count ]( ) );
+  bool order_check = true;
+  HoldStats cons_stats;
+  clock_type::time_point start_time;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.count    = prod_count;
+    thread_cfg.func     = [ & ]( unsigned num ) {
+      const item_type id = static_cast< item_type >( num ) << 56;
+      for( uint64_t i = 0; i < per_prod; ++i )
+        queue.push( id | i );
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.count    = 1;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      hold_stats( ) = HoldStats( );
+      buffer_type buffer;
+      for( uint64_t received = 0; received < total; ) {
+        item_type item = 0;
+        if( Swap ) {
+          if( !buffer.size( ) )
+            queue.swap( buffer );
+          if( !buffer.pop( item ) ) {
+            std::this_thread::yield( );
+            continue;
+          }
+        } else if( !queue.pop( item ) ) {
+          std::this_thread::yield( );
+          continue;
+        }
+        const unsigned prod_num = static_cast< unsigned >( item >> 56 );
+        order_check &= ( prod_num < prod_count ) && ( ( item & 0x00FFFFFFFFFFFFFFull ) == next[ prod_num ]++ );
+        ++received;
+      }
+      cons_stats = hold_stats( );
+    };
+    consumer.initialize( thread_cfg );
+
+    start_time = clock_type::now( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration = clock_type::now( ) - start_time;
+  const std::chrono::nanoseconds cons_hold = cons_stats.hold;
+
+  BOOST_CHECK( order_check );
+  for( unsigned num( 0 ); num < prod_count; ++num )
+    BOOST_CHECK( next[ num ] == per_prod );
+
+  Result result;
+  if( total ) {
+    result.ns_per_item        = double( duration.count( ) ) / total;
+    result.cons_hold_per_item = double( cons_hold.count( ) ) / total;
+  }
+  if( cons_stats.locks )
+    result.cons_hold_per_lock = double( cons_hold.count( ) ) / cons_stats.locks;
+  return result;
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_queue_swap )
+{
+  concur::Queue< item_type > queue;
+  concur::Queue< item_type >::buffer_type buffer;
+
+  for( item_type i( 0 ); i < 5; ++i )
+    queue.push( i );
+
+  queue.swap( buffer );
+  BOOST_CHECK( queue.size( ) == 0 && buffer.size( ) == 5 );
+
+  // the queue goes on while the batch is processed
+  queue.push( item_type( 5 ) );
+  for( item_type i( 0 ); i < 5; ++i ) {
+    item_type item = 0;
+    BOOST_CHECK( buffer.pop( item ) && item == i );
+  }
+
+  queue.swap( buffer );
+  item_type item = 0;
+  BOOST_CHECK( buffer.size( ) == 1 && buffer.pop( item ) && item == 5 );
+  BOOST_CHECK( !queue.pop( item ) );
+} // CASE_queue_swap
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_queue_swap_producers )
+{
+  for( unsigned prod_count( 1 ); prod_count <= 16; prod_count *= 2 ) {
+    const Result pop_rate  = run< std::mutex, false >( prod_count );
+    const Result swap_rate = run< std::mutex, true >( prod_count );
+    const Result pop_hold  = run< TimedMutex, false >( prod_count );
+    const Result swap_hold = run< TimedMutex, true >( prod_count );
+
+    BOOST_TEST_MESSAGE( prod_count << " producers, pop:  " << pop_rate.ns_per_item << " ns/item; consumer holds "
+                        << pop_hold.cons_hold_per_item << " ns/item, " << pop_hold.cons_hold_per_lock << " ns/lock" );
+    BOOST_TEST_MESSAGE( prod_count << " producers, swap: " << swap_rate.ns_per_item << " ns/item; consumer holds "
+                        << swap_hold.cons_hold_per_item << " ns/item, " << swap_hold.cons_hold_per_lock << " ns/lock" );
+  }
+} // CASE_queue_swap_producers
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_queue_swap
+//--------------------------------------------------------------------------------
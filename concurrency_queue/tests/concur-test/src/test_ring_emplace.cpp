@@ -0,0 +1,194 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <atomic>
+# include <chrono>
+# include <cstring>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scmp_ring_array.h>
+# include <scsp_ring_array.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_ring_emplace )
+//--------------------------------------------------------------------------------
+
+// copies and moves made by the current thread
+thread_local uint64_t payload_copies = 0;
+
+template < std::size_t Size >
+struct Payload
+{
+  Payload( ) : id( 0 ) { }
+  Payload( uint64_t num ) : id( num ) { std::memset( body, static_cast< int >( num ), sizeof( body ) ); }
+
+  Payload( const Payload& x ) : id( x.id )            { std::memcpy( body, x.body, sizeof( body ) ); ++payload_copies; }
+  Payload& operator =( const Payload& x )             { id = x.id; std::memcpy( body, x.body, sizeof( body ) ); ++payload_copies; return *this; }
+
+  uint64_t  id;
+  char      body[ Size - sizeof( uint64_t ) ];
+};
+
+//--------------------------------------------------------------------------------
+
+template < std::size_t Size > struct ScspRing
+{
+  typedef concur::ScspRingArray< Payload< Size >, 64 >  type;
+  static const char* name( ) { return "ScspRingArray"; }
+};
+
+template < std::size_t Size > struct ScmpRing
+{
+  typedef concur::ScmpRingArray< Payload< Size >, 64 >  type;
+  static const char* name( ) { return "ScmpRingArray"; }
+};
+
+//--------------------------------------------------------------------------------
+
+// 'InPlace' producer emplaces from the id and the consumer reads in place,
+// otherwise the producer pushes a ready payload and the consumer pops it out.
+template < template < std::size_t > class Ring, std::size_t Size, bool InPlace >
+void run( )
+{
+  typedef typename Ring< Size >::type ring_type;
+  typedef Payload< Size >             payload_type;
+
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+
+  ring_type ring;
+  ring.init( cfg.container_capacity );
+
+  std::atomic< uint64_t > copies{ 0 };
+  bool order_check = true;
+  std::chrono::steady_clock::time_point start_time;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      payload_copies = 0;
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        if( InPlace ) {
+          while( !ring.try_emplace( i ) )
+            ;
+        } else {
+          const payload_type src( i );
+          while( !ring.push( src ) )
+            ;
+        }
+      }
+      copies.fetch_add( payload_copies );
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      payload_copies = 0;
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        if( InPlace ) {
+          while( !ring.consume( [ & ]( const payload_type& p ) { order_check &= ( p.id == i ); } ) )
+            ;
+        } else {
+          payload_type dst;
+          while( !ring.pop( dst ) )
+            ;
+          order_check &= ( dst.id == i );
+        }
+      }
+      copies.fetch_add( payload_copies );
+    };
+    consumer.initialize( thread_cfg );
+
+    start_time = std::chrono::steady_clock::now( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( order_check );
+  BOOST_CHECK( !InPlace || copies.load( ) == 0 );
+  BOOST_TEST_MESSAGE( Ring< Size >::name( ) << " " << Size << "B, " << ( InPlace ? "try_emplace/consume" : "push/pop" )
+                      << ": " << ( op_count ? double( duration.count( ) ) / op_count : 0.0 ) << " ns/op; "
+                      << ( op_count ? double( copies.load( ) ) / op_count : 0.0 ) << " copies/op" );
+}
+
+template < template < std::size_t > class Ring >
+void run_sizes( )
+{
+  run< Ring, 64, false >( );
+  run< Ring, 64, true >( );
+  run< Ring, 256, false >( );
+  run< Ring, 256, true >( );
+  run< Ring, 1024, false >( );
+  run< Ring, 1024, true >( );
+}
+
+//--------------------------------------------------------------------------------
+
+// no default constructor, counts live instances
+struct Tracked
+{
+  static int live;
+
+  explicit Tracked( int v ) : value( v ) { ++live; }
+  Tracked( const Tracked& x ) : value( x.value ) { ++live; }
+  ~Tracked( ) { --live; }
+  Tracked& operator =( const Tracked& ) = default;
+
+  int value;
+};
+
+int Tracked::live = 0;
+
+template < typename RingType >
+void check_in_place( )
+{
+  {
+    RingType ring;
+    ring.init( 4 );
+
+    BOOST_CHECK( ring.front( ) == nullptr );
+    BOOST_CHECK( ring.try_emplace( 1 ) && ring.try_emplace( 2 ) && ring.push( Tracked( 3 ) ) );
+    BOOST_CHECK( Tracked::live == 3 );
+
+    Tracked* front = ring.front( );
+    BOOST_REQUIRE( front );
+    BOOST_CHECK( front->value == 1 && ring.front( ) == front );
+    ring.pop_commit( );
+    BOOST_CHECK( Tracked::live == 2 );
+
+    int value = 0;
+    BOOST_CHECK( ring.consume( [ & ]( Tracked& t ) { value = t.value; } ) );
+    BOOST_CHECK( value == 2 && Tracked::live == 1 );
+
+    // a throwing consumer leaves the element in the ring
+    BOOST_CHECK_THROW( ring.consume( [ ]( Tracked& ) { throw 1; } ), int );
+    BOOST_CHECK( ring.front( ) && ring.front( )->value == 3 );
+  }
+  // the ring destroys what is left in it
+  BOOST_CHECK( Tracked::live == 0 );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_ring_in_place )
+{
+  check_in_place< concur::ScspRingArray< Tracked > >( );
+  check_in_place< concur::ScmpRingArray< Tracked, 64 > >( );
+} // CASE_ring_in_place
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_ring_emplace )
+{
+  run_sizes< ScspRing >( );
+  run_sizes< ScmpRing >( );
+} // CASE_ring_emplace
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_ring_emplace
+//--------------------------------------------------------------------------------
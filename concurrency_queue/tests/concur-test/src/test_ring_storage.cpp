@@ -0,0 +1,180 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <chrono>
+# include <cstring>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+//--------------------------------------------------------------------------------
+# include <scsp_ring_array.h>
+//--------------------------------------------------------------------------------
+# ifdef __linux__
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+# endif
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_ring_storage )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t                    item_type;
+typedef concur::utils::pow2_index   index_type;
+
+// 64-byte nodes: 64MB of ring
+const unsigned RING_SIZE = 1u << 20;
+
+//--------------------------------------------------------------------------------
+
+// Data TLB read misses of the calling thread, if perf counters are available.
+class TlbMissCounter
+{
+public:
+  TlbMissCounter( )
+  {
+# ifdef __linux__
+    perf_event_attr attr;
+    std::memset( &attr, 0, sizeof( attr ) );
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.size           = sizeof( attr );
+    attr.config         = PERF_COUNT_HW_CACHE_DTLB
+                        | ( PERF_COUNT_HW_CACHE_OP_READ << 8 )
+                        | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fd_ = static_cast< int >( syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 ) );
+# endif
+  }
+
+  ~TlbMissCounter( )
+  {
+# ifdef __linux__
+    if( fd_ >= 0 )
+      close( fd_ );
+# endif
+  }
+
+  inline bool available( ) const { return fd_ >= 0; }
+
+  void start( )
+  {
+# ifdef __linux__
+    if( fd_ >= 0 ) {
+      ioctl( fd_, PERF_EVENT_IOC_RESET, 0 );
+      ioctl( fd_, PERF_EVENT_IOC_ENABLE, 0 );
+    }
+# endif
+  }
+
+  uint64_t stop( )
+  {
+    uint64_t count = 0;
+# ifdef __linux__
+    if( fd_ >= 0 ) {
+      ioctl( fd_, PERF_EVENT_IOC_DISABLE, 0 );
+      if( read( fd_, &count, sizeof( count ) ) != sizeof( count ) )
+        count = 0;
+    }
+# endif
+    return count;
+  }
+
+private:
+  int fd_ = -1;
+};
+
+//--------------------------------------------------------------------------------
+
+// The ring is kept full, so every pop and push touch nodes a whole ring apart
+// and the working set is the entire storage.
+template < typename StoragePolicy >
+void run( const char* title )
+{
+  typedef concur::ScspRingArray< item_type, 64, index_type, StoragePolicy > ring_type;
+
+  const uint64_t op_count = static_cast< uint64_t >( get_config( ).operation_count );
+
+  ring_type ring;
+  ring.init( RING_SIZE );
+
+  for( item_type i = 0; i < RING_SIZE - 1; ++i )
+    ring.push( i );
+
+  TlbMissCounter counter;
+  uint64_t sum = 0;
+
+  counter.start( );
+  const auto start_time = std::chrono::steady_clock::now( );
+  for( uint64_t i = 0; i < op_count; ++i ) {
+    item_type dst = 0;
+    ring.pop( dst );
+    ring.push( dst );
+    sum += dst;
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+  const uint64_t misses = counter.stop( );
+
+  BOOST_CHECK( sum != 0 || op_count == 0 );
+  if( counter.available( ) ) {
+    BOOST_TEST_MESSAGE( title << ": " << ( op_count ? double( duration.count( ) ) / op_count : 0.0 ) << " ns/op; "
+                        << ( op_count ? double( misses ) * 1000.0 / op_count : 0.0 ) << " dTLB misses per 1K ops" );
+  } else {
+    BOOST_TEST_MESSAGE( title << ": " << ( op_count ? double( duration.count( ) ) / op_count : 0.0 ) << " ns/op; "
+                        << "dTLB misses n/a" );
+  }
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_mapped_storage )
+{
+  const std::size_t size = 4u << 20;
+
+  concur::utils::mapped_storage< true > storage;
+  void* ptr = storage.allocate( 64, size );
+  BOOST_REQUIRE( ptr );
+  BOOST_CHECK( !( reinterpret_cast< uintptr_t >( ptr ) % 64 ) );
+  std::memset( ptr, 1, size );
+  BOOST_TEST_MESSAGE( "mapped_storage: mapped " << storage.mapped( )
+                      << ", MAP_HUGETLB " << storage.huge_pages( ) );
+  storage.deallocate( ptr, size );
+
+  // bigger alignment than a page: falls back to the heap
+  concur::utils::mapped_storage< false, 0 > fallback;
+  ptr = fallback.allocate( 1u << 16, 1024 );
+  BOOST_REQUIRE( ptr );
+  BOOST_CHECK( !fallback.mapped( ) );
+  BOOST_CHECK( !( reinterpret_cast< uintptr_t >( ptr ) % ( 1u << 16 ) ) );
+  fallback.deallocate( ptr, 1024 );
+} // CASE_mapped_storage
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_aligned_array )
+{
+  struct ALIGNAS( 64 ) Padded
+  {
+    int value = 7;
+  };
+
+  concur::utils::aligned_array< Padded > arr = concur::utils::make_aligned_array< Padded >( 5 );
+  for( std::size_t i( 0 ); i < 5; ++i ) {
+    BOOST_CHECK( !( reinterpret_cast< uintptr_t >( &arr[ i ] ) % 64 ) );
+    BOOST_CHECK( arr[ i ].value == 7 );
+  }
+} // CASE_aligned_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_ring_storage )
+{
+  run< concur::utils::heap_storage >( "ScspRingArray heap_storage" );
+  run< concur::utils::mapped_storage< false > >( "ScspRingArray mapped_storage<4K pages>" );
+  run< concur::utils::mapped_storage< true > >( "ScspRingArray mapped_storage<huge pages>" );
+  run< concur::utils::mapped_storage< true, 0 > >( "ScspRingArray mapped_storage<huge pages, node 0>" );
+} // CASE_ring_storage
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_ring_storage
+//--------------------------------------------------------------------------------
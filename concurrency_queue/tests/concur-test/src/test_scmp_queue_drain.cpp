@@ -0,0 +1,162 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <chrono>
+# include <iterator>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scmp_queue.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scmp_queue_drain )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t                        item_type;
+typedef concur::ScmpQueue< item_type >  queue_type;
+typedef concur::ScmpQueue< item_type, concur::utils::recycled_nodes< 1024 > >  recycled_queue_type;
+
+const unsigned BURST_SIZES[ ] = { 1, 8, 64, 512 };
+
+//--------------------------------------------------------------------------------
+
+double to_ns_per_op( std::chrono::nanoseconds duration, uint64_t ops )
+{
+  return ops ? double( duration.count( ) ) / double( ops ) : 0.0;
+}
+
+// Single thread: push a burst, then drain it either element by element or with
+// a single 'consume_all'.
+template < typename QueueType >
+void run_bursts( const char* title, unsigned burst, bool drain_all )
+{
+  const uint64_t op_count = static_cast< uint64_t >( get_config( ).operation_count );
+
+  QueueType queue;
+
+  uint64_t sum = 0;
+  uint64_t popped = 0;
+  const auto start_time = std::chrono::steady_clock::now( );
+  for( uint64_t i = 0; i < op_count; ) {
+    for( unsigned k( 0 ); k < burst && i < op_count; ++k )
+      queue.push( i++ );
+
+    if( drain_all ) {
+      popped += queue.consume_all( [ &sum ]( item_type&& v ) { sum += v; } ).count;
+    } else {
+      item_type dst = 0;
+      while( queue.pop( dst ) ) {
+        sum += dst;
+        ++popped;
+      }
+    }
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( popped == op_count );
+  BOOST_CHECK( sum == op_count * ( op_count - 1 ) / 2 );
+  BOOST_TEST_MESSAGE( title << ", burst " << burst << ", " << ( drain_all ? "consume_all" : "pop" ) << ": "
+                      << to_ns_per_op( duration, op_count ) << " ns/op" );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_drain_basic )
+{
+  queue_type queue;
+  std::vector< item_type > dst;
+
+  queue_type::DrainResult result = queue.pop_all( std::back_inserter( dst ) );
+  BOOST_CHECK( result.count == 0 && !result.gap );
+
+  for( item_type i = 0; i < 10; ++i )
+    queue.push( i );
+
+  result = queue.pop_all( std::back_inserter( dst ) );
+  BOOST_CHECK( result.count == 10 && !result.gap );
+  BOOST_REQUIRE( dst.size( ) == 10 );
+  for( item_type i = 0; i < 10; ++i )
+    BOOST_CHECK( dst[ i ] == i );
+
+  queue.push( 10 );
+  item_type v = 0;
+  BOOST_CHECK( queue.pop( v ) && v == 10 );
+  BOOST_CHECK( queue.pop_all( std::back_inserter( dst ) ).count == 0 );
+
+  // the element 'func' throws on stays in the queue, the ones before it don't
+  for( item_type i = 0; i < 4; ++i )
+    queue.push( i );
+  item_type consumed = 0;
+  BOOST_CHECK_THROW( queue.consume_all( [ &consumed ]( item_type&& v ) {
+                                          if( v == 2 ) throw v;
+                                          ++consumed;
+                                        } ), item_type );
+  BOOST_CHECK( consumed == 2 );
+  BOOST_CHECK( queue.pop( v ) && v == 2 && queue.pop( v ) && v == 3 && !queue.pop( v ) );
+} // CASE_drain_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_drain_mt )
+{
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+  const uint64_t total = op_count * cfg.prod_thread_count;
+
+  queue_type queue;
+
+  uint64_t sum = 0;
+  uint64_t drains = 0;
+  uint64_t gaps = 0;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.count    = cfg.prod_thread_count;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < op_count; ++i )
+        queue.push( i );
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.count    = 1;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t popped = 0; popped < total; ) {
+        const queue_type::DrainResult result = queue.consume_all( [ &sum ]( item_type&& v ) { sum += v; } );
+        popped += result.count;
+        drains += ( result.count != 0 );
+        gaps   += result.gap;
+      }
+    };
+    consumer.initialize( thread_cfg );
+
+    producer.launch( );
+    consumer.launch( );
+  }
+
+  BOOST_CHECK( sum == cfg.prod_thread_count * ( op_count * ( op_count - 1 ) / 2 ) );
+  BOOST_TEST_MESSAGE( "consume_all (" << cfg.prod_thread_count << " producers): "
+                      << drains << " non-empty drains, " << gaps << " stopped before the tail" );
+} // CASE_drain_mt
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_drain_bursts )
+{
+  for( unsigned burst : BURST_SIZES ) {
+    run_bursts< queue_type >( "heap_nodes", burst, false );
+    run_bursts< queue_type >( "heap_nodes", burst, true );
+  }
+  for( unsigned burst : BURST_SIZES ) {
+    run_bursts< recycled_queue_type >( "recycled_nodes<1024>", burst, false );
+    run_bursts< recycled_queue_type >( "recycled_nodes<1024>", burst, true );
+  }
+} // CASE_drain_bursts
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmp_queue_drain
+//--------------------------------------------------------------------------------
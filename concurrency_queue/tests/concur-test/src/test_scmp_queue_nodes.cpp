@@ -0,0 +1,183 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <atomic>
+# include <chrono>
+# include <stdexcept>
+# include <thread>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scmp_queue.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scmp_queue_nodes )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t item_type;
+
+// heap_nodes counting the nodes it takes from the heap and the discarded ones
+struct counting_heap_nodes
+{
+  static std::atomic< uint64_t > alloc_count;
+  static std::atomic< uint64_t > discard_count;
+
+  template < typename NodeT >
+  struct pool : concur::utils::heap_nodes::pool< NodeT >
+  {
+    inline void* take( )
+    {
+      alloc_count.fetch_add( 1, std::memory_order_relaxed );
+      return concur::utils::heap_nodes::pool< NodeT >::take( );
+    }
+
+    inline void discard( void* ptr )
+    {
+      discard_count.fetch_add( 1, std::memory_order_relaxed );
+      concur::utils::heap_nodes::pool< NodeT >::discard( ptr );
+    }
+  };
+};
+
+std::atomic< uint64_t > counting_heap_nodes::alloc_count( 0 );
+std::atomic< uint64_t > counting_heap_nodes::discard_count( 0 );
+
+// its constructor throws on a negative value
+struct Picky
+{
+  int value;
+
+  Picky( int v = 0 ) : value( v )
+  {
+    if( v < 0 )
+      throw std::invalid_argument( "negative" );
+  }
+};
+
+struct ALIGNAS( 128 ) Wide
+{
+  int value;
+};
+
+template < std::size_t Capacity >
+using counting_recycled_nodes = concur::utils::recycled_nodes< Capacity, counting_heap_nodes >;
+
+// producers don't run further ahead of the consumer than this (steady state)
+const uint64_t MAX_IN_FLIGHT = 256;
+
+//--------------------------------------------------------------------------------
+
+// Producers push 'operation_count' items each, the single consumer pops them
+// all. Reports node allocations from the heap per million operations and ns/op.
+// At most 'MAX_IN_FLIGHT' items are queued at a time, so the consumer keeps up
+// and released nodes can actually be reused.
+template < typename QueueType >
+void run( const char* title )
+{
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+  const uint64_t total = op_count * cfg.prod_thread_count;
+
+  QueueType queue;
+
+  std::atomic< uint64_t > in_flight( 0 );
+  uint64_t sum = 0;
+  uint64_t allocs = 0;
+  std::chrono::steady_clock::time_point start_time;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.count    = cfg.prod_thread_count;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        while( in_flight.load( std::memory_order_relaxed ) >= MAX_IN_FLIGHT )
+          std::this_thread::yield( );
+        in_flight.fetch_add( 1, std::memory_order_relaxed );
+        queue.push( i );
+      }
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.count    = 1;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < total; ++i ) {
+        item_type dst = 0;
+        while( !queue.pop( dst ) )
+          ;
+        in_flight.fetch_sub( 1, std::memory_order_relaxed );
+        sum += dst;
+      }
+    };
+    consumer.initialize( thread_cfg );
+
+    allocs = counting_heap_nodes::alloc_count.load( );
+    start_time = std::chrono::steady_clock::now( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+  allocs = counting_heap_nodes::alloc_count.load( ) - allocs;
+
+  BOOST_CHECK( sum == cfg.prod_thread_count * ( op_count * ( op_count - 1 ) / 2 ) );
+  BOOST_TEST_MESSAGE( title << " (" << cfg.prod_thread_count << " producers): "
+                      << ( total ? double( allocs ) * 1000000.0 / total : 0.0 ) << " mallocs per 1M ops; "
+                      << ( total ? double( duration.count( ) ) / total : 0.0 ) << " ns/op" );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_recycled_nodes )
+{
+  counting_recycled_nodes< 4 >::pool< uint64_t > pool;
+
+  void* ptrs[ 6 ];
+  for( void*& ptr : ptrs )
+    ptr = pool.take( );
+
+  const uint64_t allocs = counting_heap_nodes::alloc_count.load( );
+  for( void* ptr : ptrs )
+    pool.give( ptr ); // the last two go to the heap
+  for( unsigned i( 0 ); i < 4; ++i )
+    BOOST_CHECK( pool.take( ) == ptrs[ i ] );
+  BOOST_CHECK( counting_heap_nodes::alloc_count.load( ) == allocs );
+
+  for( unsigned i( 0 ); i < 4; ++i )
+    pool.give( ptrs[ i ] );
+
+  // a node whose element throws goes back through the policy
+  concur::ScmpQueue< Picky, counting_recycled_nodes< 4 > > queue;
+  const uint64_t discards = counting_heap_nodes::discard_count.load( );
+  BOOST_CHECK_THROW( queue.push( -1 ), std::invalid_argument );
+  BOOST_CHECK( counting_heap_nodes::discard_count.load( ) == discards + 1 );
+  Picky dst;
+  BOOST_CHECK( queue.push( 1 ) && queue.pop( dst ) && dst.value == 1 );
+
+  // over-aligned nodes are aligned
+  concur::utils::heap_nodes::pool< Wide > wide;
+  void* ptr = wide.take( );
+  BOOST_CHECK( !( reinterpret_cast< uintptr_t >( ptr ) % 128 ) );
+  wide.give( ptr );
+} // CASE_recycled_nodes
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmp_queue_heap_nodes )
+{
+  run< concur::ScmpQueue< item_type, counting_heap_nodes > >( "ScmpQueue heap_nodes" );
+} // CASE_scmp_queue_heap_nodes
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmp_queue_recycled_nodes )
+{
+  run< concur::ScmpQueue< item_type, counting_recycled_nodes< 1024 > > >( "ScmpQueue recycled_nodes<1024>" );
+  run< concur::ScmpQueue< item_type, counting_recycled_nodes< 64 > > >( "ScmpQueue recycled_nodes<64>" );
+} // CASE_scmp_queue_recycled_nodes
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmp_queue_nodes
+//--------------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <memory>
+# include <chrono>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scmp_ring_array.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scmp_ring_array_bulk )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t                                item_type;
+typedef concur::ScmpRingArray< item_type, 64 >  ring_type;
+typedef std::vector< item_type >                receiver_type;
+
+const unsigned MAX_BATCH = 64;
+
+//--------------------------------------------------------------------------------
+
+// Producers push tagged sequences, the consumer checks per-producer order.
+// 'batch' == 0 means the single-element push/pop path.
+void run( unsigned batch, const char* title )
+{
+  const Config& cfg = get_config( );
+
+  ring_type ring;
+  ring.init( cfg.container_capacity );
+
+  std::unique_ptr< receiver_type[ ] > recs( new receiver_type[ cfg.prod_thread_count ] );
+  for( unsigned i( 0 ); i < cfg.prod_thread_count; ++i )
+    recs[ i ].reserve( cfg.operation_count );
+
+  std::chrono::nanoseconds start_time;
+  {
+    ThreadMaster consumer;
+    ThreadMaster producer;
+
+    {
+      ThreadMaster::Config thread_cfg;
+      thread_cfg.affinity = cfg.prod_thread_affinity;
+      thread_cfg.count    = cfg.prod_thread_count;
+      thread_cfg.func     = [ & ]( unsigned num ) {
+        const uint64_t id = static_cast< uint64_t >( num ) << 56;
+        const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+
+        if( !batch ) {
+          for( uint64_t i = 0; i < op_count; ++i ) {
+            while( !ring.push( id | i ) )
+              ;
+          }
+          return;
+        }
+
+        item_type items[ MAX_BATCH ];
+        for( uint64_t i = 0; i < op_count; ) {
+          const unsigned count = static_cast< unsigned >(
+                ( std::min )( static_cast< uint64_t >( batch ), op_count - i ) );
+          for( unsigned k( 0 ); k < count; ++k )
+            items[ k ] = id | ( i + k );
+
+          unsigned pushed = 0;
+          while( pushed < count )
+            pushed += ring.push_bulk( items + pushed, items + count );
+          i += count;
+        }
+      };
+      producer.initialize( thread_cfg );
+    } {
+      ThreadMaster::Config thread_cfg;
+      thread_cfg.affinity = cfg.cons_thread_affinity;
+      thread_cfg.count    = 1;
+      thread_cfg.func     = [ & ]( unsigned ) {
+        const uint64_t total = cfg.operation_count * cfg.prod_thread_count;
+
+        item_type items[ MAX_BATCH ];
+        for( uint64_t i = 0; i < total; ) {
+          unsigned count = 0;
+          if( !batch ) {
+            while( !ring.pop( items[ 0 ] ) )
+              ;
+            count = 1;
+          } else {
+            while( !( count = ring.pop_bulk( items, batch ) ) )
+              ;
+          }
+
+          for( unsigned k( 0 ); k < count; ++k ) {
+            const unsigned prod_num = static_cast< unsigned >( items[ k ] >> 56 );
+            recs[ prod_num ].push_back( items[ k ] & 0x00FFFFFFFFFFFFFFull );
+          }
+          i += count;
+        }
+      };
+      consumer.initialize( thread_cfg );
+    }
+
+    start_time = std::chrono::steady_clock::now( ).time_since_epoch( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration =
+      std::chrono::steady_clock::now( ).time_since_epoch( ) - start_time;
+
+  const double total = double( cfg.operation_count ) * cfg.prod_thread_count;
+  BOOST_TEST_MESSAGE( title << ": duration " << ( duration.count( ) / 1000000000.0 )
+                      << " sec.; " << ( duration.count( ) / total ) << " ns/op" );
+
+  // check
+  for( unsigned num( 0 ); num < cfg.prod_thread_count; ++num ) {
+    receiver_type& rec = recs[ num ];
+    BOOST_REQUIRE( rec.size( ) == static_cast< std::size_t >( cfg.operation_count ) );
+    for( uint64_t i( 0 ); i < rec.size( ); ++i ) {
+      if( rec[ i ] != i ) {
+        BOOST_CHECK( rec[ i ] == i );
+        break;
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_bulk_basic )
+{
+  ring_type ring;
+  ring.init( 10 );
+
+  item_type src[ 16 ];
+  for( unsigned i( 0 ); i < 16; ++i )
+    src[ i ] = i;
+
+  // only the leading part fits
+  BOOST_CHECK( ring.push_bulk( src, src + 16 ) == 10 );
+  BOOST_CHECK( ring.push_bulk( src, src + 1 ) == 0 );
+  BOOST_CHECK( !ring.push( 0 ) );
+
+  item_type dst[ 16 ] = { };
+  BOOST_CHECK( ring.pop_bulk( dst, 4 ) == 4 );
+  BOOST_CHECK( ring.push_bulk( src + 10, src + 16 ) == 4 );
+  BOOST_CHECK( ring.pop_bulk( dst + 4, 16 ) == 10 );
+  BOOST_CHECK( ring.pop_bulk( dst, 16 ) == 0 );
+
+  for( unsigned i( 0 ); i < 14; ++i )
+    BOOST_CHECK( dst[ i ] == i );
+} // CASE_bulk_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_single_element )
+{
+  run( 0, "ScmpRingArray push/pop" );
+} // CASE_single_element
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_bulk_1 )
+{
+  run( 1, "ScmpRingArray bulk 1" );
+} // CASE_bulk_1
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_bulk_8 )
+{
+  run( 8, "ScmpRingArray bulk 8" );
+} // CASE_bulk_8
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_bulk_64 )
+{
+  run( 64, "ScmpRingArray bulk 64" );
+} // CASE_bulk_64
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmp_ring_array_bulk
+//--------------------------------------------------------------------------------
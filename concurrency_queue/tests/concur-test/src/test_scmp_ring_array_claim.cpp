@@ -0,0 +1,173 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <algorithm>
+# include <atomic>
+# include <memory>
+# include <thread>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scmp_ring_array.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scmp_ring_array_claim )
+//--------------------------------------------------------------------------------
+
+// Producers fill the words one by one between claim and commit, a consumer
+// seeing a half-written message would find them differ.
+struct Message
+{
+  static const unsigned WORD_COUNT = 16;
+
+  uint64_t words[ WORD_COUNT ];
+
+  void fill( uint64_t value )
+  {
+    for( uint64_t& w : words )
+      w = value;
+  }
+
+  bool consistent( ) const
+  {
+    for( const uint64_t& w : words ) {
+      if( w != words[ 0 ] )
+        return false;
+    }
+    return true;
+  }
+};
+
+typedef concur::ScmpRingArray< Message, 64 >  ring_type;
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_claim_basic )
+{
+  ring_type ring;
+  ring.init( 3 );
+
+  Message* a = ring.producer_claim( );
+  Message* b = ring.producer_claim( );
+  Message* c = ring.producer_claim( );
+  BOOST_REQUIRE( a && b && c );
+  BOOST_CHECK( ring.producer_claim( ) == nullptr );   // full
+
+  // committed out of order: nothing is visible till the first one
+  b->fill( 2 );
+  ring.producer_commit( b );
+  c->fill( 3 );
+  ring.producer_commit( c );
+  BOOST_CHECK( ring.front( ) == nullptr );
+
+  a->fill( 1 );
+  ring.producer_commit( a );
+
+  for( uint64_t expected( 1 ); expected <= 3; ++expected ) {
+    BOOST_CHECK( ring.consume( [ & ]( const Message& m ) {
+      BOOST_CHECK( m.consistent( ) && m.words[ 0 ] == expected );
+    } ) );
+  }
+  BOOST_CHECK( ring.front( ) == nullptr );
+
+  // the slots are reusable, claims mix with pushes
+  Message m;
+  m.fill( 5 );
+  BOOST_CHECK( ring.push( m ) );
+  Message* d = ring.producer_claim( );
+  BOOST_REQUIRE( d );
+  d->fill( 6 );
+  ring.producer_commit( d );
+
+  Message dst;
+  BOOST_CHECK( ring.pop( dst ) && dst.words[ 0 ] == 5 );
+  BOOST_CHECK( ring.pop( dst ) && dst.words[ 0 ] == 6 );
+
+  // elements claimed but not committed are destroyed with the ring
+  const std::shared_ptr< int > item = std::make_shared< int >( 0 );
+  {
+    concur::ScmpRingArray< std::shared_ptr< int >, 64 > items;
+    items.init( 3 );
+    BOOST_CHECK( items.push( item ) );
+    BOOST_CHECK( items.producer_claim( item ) && items.producer_claim( ) );
+    BOOST_CHECK( item.use_count( ) == 3 );
+  }
+  BOOST_CHECK( item.use_count( ) == 1 );
+} // CASE_claim_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_claim_mt )
+{
+  const Config& cfg = get_config( );
+  const unsigned prod_count = ( std::max )( cfg.prod_thread_count, 2u );
+  const uint64_t op_count   = static_cast< uint64_t >( cfg.operation_count );
+
+  ring_type ring;
+  ring.init( cfg.container_capacity );
+
+  std::unique_ptr< uint64_t[ ] > next( new uint64_t[ prod_count ]( ) );
+  std::atomic< uint64_t > torn{ 0 };
+  std::atomic< uint64_t > disorder{ 0 };
+  {
+    ThreadMaster consumer;
+    ThreadMaster producer;
+
+    {
+      ThreadMaster::Config thread_cfg;
+      thread_cfg.affinity = cfg.prod_thread_affinity;
+      thread_cfg.count    = prod_count;
+      thread_cfg.func     = [ & ]( unsigned num ) {
+        const uint64_t id = static_cast< uint64_t >( num ) << 56;
+        for( uint64_t i = 0; i < op_count; ++i ) {
+          Message* m = nullptr;
+          while( !( m = ring.producer_claim( ) ) )
+            ;
+          // hold some of the claims for a while to get commits reordered
+          for( unsigned w( 0 ); w < Message::WORD_COUNT; ++w ) {
+            m->words[ w ] = id | i;
+            if( !( ( i + num ) % 97 ) && w == Message::WORD_COUNT / 2 )
+              std::this_thread::yield( );
+          }
+          ring.producer_commit( m );
+        }
+      };
+      producer.initialize( thread_cfg );
+    } {
+      ThreadMaster::Config thread_cfg;
+      thread_cfg.affinity = cfg.cons_thread_affinity;
+      thread_cfg.count    = 1;
+      thread_cfg.func     = [ & ]( unsigned ) {
+        const uint64_t total = op_count * prod_count;
+        for( uint64_t i = 0; i < total; ++i ) {
+          while( !ring.consume( [ & ]( const Message& m ) {
+            if( !m.consistent( ) ) {
+              torn.fetch_add( 1, std::memory_order_relaxed );
+              return;
+            }
+            const unsigned prod_num = static_cast< unsigned >( m.words[ 0 ] >> 56 );
+            const uint64_t seq      = m.words[ 0 ] & 0x00FFFFFFFFFFFFFFull;
+            if( prod_num >= prod_count || seq != next[ prod_num ]++ )
+              disorder.fetch_add( 1, std::memory_order_relaxed );
+          } ) )
+            ;
+        }
+      };
+      consumer.initialize( thread_cfg );
+    }
+
+    producer.launch( );
+    consumer.launch( );
+  }
+
+  BOOST_CHECK( torn.load( ) == 0 );
+  BOOST_CHECK( disorder.load( ) == 0 );
+  for( unsigned num( 0 ); num < prod_count; ++num )
+    BOOST_CHECK( next[ num ] == op_count );
+  BOOST_CHECK( ring.front( ) == nullptr );
+} // CASE_claim_mt
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmp_ring_array_claim
+//--------------------------------------------------------------------------------
@@ -0,0 +1,133 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <chrono>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scsp_cached_ring_array.h>
+# include <scsp_ring_array.h>
+# include <scsp_ptr_ring_array.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scsp_cached_ring_array )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t item_type;
+
+//--------------------------------------------------------------------------------
+
+// ScspPtrRingArray carries pointers, others carry values; 0 is not a valid pointer
+template < typename ElementT > struct Value
+{
+  static ElementT  make( uint64_t i )     { return i; }
+  static uint64_t  get( ElementT v )      { return v; }
+};
+
+template < typename T > struct Value< T* >
+{
+  static T*        make( uint64_t i )     { return reinterpret_cast< T* >( i + 1 ); }
+  static uint64_t  get( T* v )            { return reinterpret_cast< uint64_t >( v ) - 1; }
+};
+
+//--------------------------------------------------------------------------------
+
+template < typename RingType >
+void run( const char* title )
+{
+  typedef typename RingType::element_type   element_type;
+  typedef Value< element_type >             value_type;
+
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+
+  RingType ring;
+  ring.init( cfg.container_capacity );
+
+  bool order_check = true;
+  std::chrono::steady_clock::time_point start_time;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        while( !ring.push( value_type::make( i ) ) )
+          ;
+      }
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        element_type dst{ };
+        while( !ring.pop( dst ) )
+          ;
+        order_check &= ( value_type::get( dst ) == i );
+      }
+    };
+    consumer.initialize( thread_cfg );
+
+    start_time = std::chrono::steady_clock::now( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( order_check );
+  BOOST_TEST_MESSAGE( title << ": duration " << ( duration.count( ) / 1000000000.0 ) << " sec.; "
+                      << ( op_count ? double( duration.count( ) ) / op_count : 0.0 ) << " ns/op" );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_basic )
+{
+  concur::ScspCachedRingArray< item_type > ring;
+  ring.init( 3 );
+
+  item_type dst = 0;
+  BOOST_CHECK( !ring.pop( dst ) );
+
+  for( unsigned round( 0 ); round < 5; ++round ) {
+    BOOST_CHECK( ring.push( round * 10 + 1 ) );
+    BOOST_CHECK( ring.push( round * 10 + 2 ) );
+    BOOST_CHECK( ring.push( round * 10 + 3 ) );
+    BOOST_CHECK( !ring.push( 0 ) );
+
+    BOOST_CHECK( ring.pop( dst ) && ( dst == round * 10 + 1 ) );
+    BOOST_CHECK( ring.push( round * 10 + 4 ) );
+    BOOST_CHECK( ring.pop( dst ) && ( dst == round * 10 + 2 ) );
+    BOOST_CHECK( ring.pop( dst ) && ( dst == round * 10 + 3 ) );
+    BOOST_CHECK( ring.pop( dst ) && ( dst == round * 10 + 4 ) );
+    BOOST_CHECK( !ring.pop( dst ) );
+  }
+} // CASE_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_cached_ring_array )
+{
+  run< concur::ScspCachedRingArray< item_type > >( "ScspCachedRingArray" );
+} // CASE_scsp_cached_ring_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_ring_array )
+{
+  run< concur::ScspRingArray< item_type > >( "ScspRingArray" );
+} // CASE_scsp_ring_array
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_ptr_ring_array )
+{
+  run< concur::ScspPtrRingArray< item_type > >( "ScspPtrRingArray" );
+} // CASE_scsp_ptr_ring_array
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scsp_cached_ring_array
+//--------------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <chrono>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <scsp_ring_array.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scsp_ring_index )
+//--------------------------------------------------------------------------------
+
+typedef uint64_t item_type;
+
+//--------------------------------------------------------------------------------
+
+// container capacity rounded up to a power of two, so both policies use the
+// same storage size
+unsigned pow2_capacity( )
+{
+  unsigned capacity = 1;
+  while( capacity < get_config( ).container_capacity )
+    capacity <<= 1;
+  return capacity;
+}
+
+double to_ns_per_op( std::chrono::nanoseconds duration, uint64_t ops )
+{
+  return ops ? double( duration.count( ) ) / double( ops ) : 0.0;
+}
+
+//--------------------------------------------------------------------------------
+
+// Single thread: push/pop pairs, isolates the cost of index computation.
+template < typename RingType >
+void run_single_thread( const char* title )
+{
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+
+  RingType ring;
+  ring.init( pow2_capacity( ) );
+
+  uint64_t sum = 0;
+  const auto start_time = std::chrono::steady_clock::now( );
+  for( uint64_t i = 0; i < op_count; ++i ) {
+    item_type dst = 0;
+    ring.push( i );
+    ring.pop( dst );
+    sum += dst;
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( sum == op_count * ( op_count - 1 ) / 2 );
+  BOOST_TEST_MESSAGE( title << " (1 thread): " << to_ns_per_op( duration, op_count ) << " ns/op" );
+}
+
+// Producer and consumer threads.
+template < typename RingType >
+void run_two_threads( const char* title )
+{
+  const Config& cfg = get_config( );
+  const uint64_t op_count = static_cast< uint64_t >( cfg.operation_count );
+
+  RingType ring;
+  ring.init( pow2_capacity( ) );
+
+  bool order_check = true;
+  std::chrono::steady_clock::time_point start_time;
+  {
+    ThreadMaster producer;
+    ThreadMaster consumer;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        while( !ring.push( i ) )
+          ;
+      }
+    };
+    producer.initialize( thread_cfg );
+
+    thread_cfg.affinity = cfg.cons_thread_affinity;
+    thread_cfg.func     = [ & ]( unsigned ) {
+      for( uint64_t i = 0; i < op_count; ++i ) {
+        item_type dst = 0;
+        while( !ring.pop( dst ) )
+          ;
+        order_check &= ( dst == i );
+      }
+    };
+    consumer.initialize( thread_cfg );
+
+    start_time = std::chrono::steady_clock::now( );
+    producer.launch( );
+    consumer.launch( );
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( order_check );
+  BOOST_TEST_MESSAGE( title << " (2 threads): " << to_ns_per_op( duration, op_count ) << " ns/op" );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_pow2_index )
+{
+  concur::utils::pow2_index index;
+
+  BOOST_CHECK_THROW( index.init( 0 ), std::invalid_argument );
+  BOOST_CHECK_THROW( index.init( 1000 ), std::invalid_argument );
+
+  index.init( 1024 );
+  BOOST_CHECK( index( 1023u ) == 1023u );
+  BOOST_CHECK( index( 1024u ) == 0u );
+  BOOST_CHECK( index( 3073u ) == 1u );
+} // CASE_pow2_index
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_ring_modulo )
+{
+  typedef concur::ScspRingArray< item_type, 64, concur::utils::modulo_index > ring_type;
+  run_single_thread< ring_type >( "ScspRingArray modulo" );
+  run_two_threads< ring_type >( "ScspRingArray modulo" );
+} // CASE_scsp_ring_modulo
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsp_ring_pow2 )
+{
+  typedef concur::ScspRingArray< item_type, 64, concur::utils::pow2_index > ring_type;
+  run_single_thread< ring_type >( "ScspRingArray pow2" );
+  run_two_threads< ring_type >( "ScspRingArray pow2" );
+} // CASE_scsp_ring_pow2
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scsp_ring_index
+//--------------------------------------------------------------------------------
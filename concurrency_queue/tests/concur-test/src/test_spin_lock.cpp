@@ -0,0 +1,163 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include <algorithm>
+# include <chrono>
+# include <memory>
+# include <mutex>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include "test_config.h"
+# include "thread_master.h"
+//--------------------------------------------------------------------------------
+# include <mt_containers.h>
+# include <utils/spin_lock.h>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_spin_lock )
+//--------------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock                 clock_type;
+typedef concur::utils::TtasSpinLock< >            ttas_lock_type;
+typedef concur::utils::TicketLock< >              ticket_lock_type;
+typedef concur::utils::AdaptiveLock< >            adaptive_lock_type;
+
+const unsigned MAX_THREAD_COUNT = 16;
+
+//--------------------------------------------------------------------------------
+
+// A critical section as short as a queue push: a few words of shared state.
+struct Shared
+{
+  uint64_t  counter = 0;
+  uint64_t  last    = 0;
+  uint64_t  sum     = 0;
+};
+
+// 'thread_count' threads lock, update the shared state and unlock for
+// 'operation_count' times altogether. Every lock acquisition is timed.
+template < typename LockType >
+void run( const char* name, unsigned thread_count )
+{
+  const Config& cfg = get_config( );
+  const uint64_t per_thread = static_cast< uint64_t >( cfg.operation_count ) / thread_count;
+  const uint64_t total      = per_thread * thread_count;
+
+  LockType lock;
+  Shared   shared;
+
+  std::unique_ptr< std::vector< uint32_t >[ ] > waits( new std::vector< uint32_t >[ thread_count ] );
+  clock_type::time_point start_time;
+  {
+    ThreadMaster threads;
+
+    ThreadMaster::Config thread_cfg;
+    thread_cfg.affinity = cfg.prod_thread_affinity;
+    thread_cfg.count    = thread_count;
+    thread_cfg.func     = [ & ]( unsigned num ) {
+      std::vector< uint32_t >& w = waits[ num ];
+      w.reserve( per_thread );
+      for( uint64_t i = 0; i < per_thread; ++i ) {
+        const clock_type::time_point before = clock_type::now( );
+        lock.lock( );
+        const clock_type::time_point after = clock_type::now( );
+        ++shared.counter;
+        shared.last = num;
+        shared.sum += i;
+        lock.unlock( );
+        w.push_back( static_cast< uint32_t >(
+              std::chrono::duration_cast< std::chrono::nanoseconds >( after - before ).count( ) ) );
+      }
+    };
+    threads.initialize( thread_cfg );
+
+    start_time = clock_type::now( );
+    threads.launch( );
+  }
+  const std::chrono::nanoseconds duration = clock_type::now( ) - start_time;
+
+  BOOST_CHECK( shared.counter == total );
+  BOOST_CHECK( shared.sum == thread_count * ( per_thread * ( per_thread - 1 ) / 2 ) );
+
+  std::vector< uint32_t > all;
+  all.reserve( total );
+  for( unsigned num( 0 ); num < thread_count; ++num )
+    all.insert( all.end( ), waits[ num ].begin( ), waits[ num ].end( ) );
+  if( all.empty( ) )
+    return;
+  std::sort( all.begin( ), all.end( ) );
+
+  const double sec = std::chrono::duration_cast< std::chrono::duration< double > >( duration ).count( );
+  BOOST_TEST_MESSAGE( name << ", " << thread_count << " threads: "
+                      << ( sec > 0.0 ? total / sec / 1000000.0 : 0.0 ) << " Mlocks/s; wait, ns:"
+                      << " p50 " << all[ all.size( ) / 2 ]
+                      << "; p99 " << all[ all.size( ) * 99 / 100 ]
+                      << "; p99.9 " << all[ all.size( ) * 999 / 1000 ]
+                      << "; max " << all.back( ) );
+}
+
+template < typename LockType >
+void run_sweep( const char* name )
+{
+  for( unsigned thread_count( 1 ); thread_count <= MAX_THREAD_COUNT; thread_count *= 2 )
+    run< LockType >( name, thread_count );
+}
+
+// the locks drop into the containers
+template < typename LockType >
+void check_containers( )
+{
+  concur::Queue< int, LockType > queue;
+  concur::RingArray< int, LockType > ring;
+  ring.init( 2 );
+
+  int dst = 0;
+  BOOST_CHECK( queue.push( 1 ) && queue.pop( dst ) && dst == 1 );
+  BOOST_CHECK( ring.push( 2 ) && ring.pop( dst ) && dst == 2 );
+  {
+    auto grab = ring.grab( );
+    BOOST_CHECK( grab.push( 3 ) && grab.size( ) == 1 );
+  }
+  BOOST_CHECK( ring.size( ) == 1 );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_spin_lock_basic )
+{
+  ttas_lock_type ttas;
+  BOOST_CHECK( ttas.try_lock( ) && !ttas.try_lock( ) );
+  ttas.unlock( );
+  BOOST_CHECK( ttas.try_lock( ) );
+  ttas.unlock( );
+
+  ticket_lock_type ticket;
+  BOOST_CHECK( ticket.try_lock( ) && !ticket.try_lock( ) );
+  ticket.unlock( );
+  ticket.lock( );
+  BOOST_CHECK( !ticket.try_lock( ) );
+  ticket.unlock( );
+
+  adaptive_lock_type adaptive;
+  BOOST_CHECK( adaptive.try_lock( ) && !adaptive.try_lock( ) );
+  adaptive.unlock( );
+  adaptive.lock( );
+  adaptive.unlock( );
+
+  check_containers< ttas_lock_type >( );
+  check_containers< ticket_lock_type >( );
+  check_containers< adaptive_lock_type >( );
+} // CASE_spin_lock_basic
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_spin_lock_contention )
+{
+  run_sweep< std::mutex >( "std::mutex" );
+  run_sweep< ttas_lock_type >( "TtasSpinLock" );
+  run_sweep< ticket_lock_type >( "TicketLock" );
+  run_sweep< adaptive_lock_type >( "AdaptiveLock" );
+} // CASE_spin_lock_contention
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_spin_lock
+//--------------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include <future>
 #include <iostream>
 #include "mcmp_list.h"
+#include "mcmp_lock_free_list.h"
 #include <vector>
 //------------------------------------------------------------------------------
 int64_t const TOTAL_HIT = 1000000;
@@ -83,3 +84,90 @@ BOOST_AUTO_TEST_CASE(scsp_concurrency) {
     << " microseconds" << std::endl;
 }
 //------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(mcmp_lock_free_push_pop) {
+  int64_t const testValues[] = {1024, -45345, 0, 234, 34, -32768};
+
+  MCMPLockFreeList< int64_t > queue;
+
+  int64_t value = 0;
+  BOOST_CHECK_EQUAL( false, queue.consume(value) );
+
+  for (auto &testValue : testValues) {
+    queue.produce(testValue);
+  }
+
+  for (size_t i = 0, n = sizeof(testValues) / sizeof(testValues[0]); i < n;
+    ++i)
+  {
+    BOOST_CHECK_EQUAL( true, queue.consume(value) );
+    BOOST_CHECK_EQUAL(testValues[i], value);
+  }
+  BOOST_CHECK_EQUAL( false, queue.consume(value) );
+}
+//------------------------------------------------------------------------------
+// Runs WRITERS_COUNT writers and READERS_COUNT readers, checks the consumed
+// sum and reports throughput and miss ratio.
+template < typename Queue >
+void runQueue(char const *aName) {
+  Queue localQueue;
+  std::vector< int64_t > localMisses(READERS_COUNT);
+  std::vector< int64_t > localSums(READERS_COUNT);
+  int64_t const perWriter = TOTAL_HIT / WRITERS_COUNT;
+  int64_t const perReader = perWriter * WRITERS_COUNT / READERS_COUNT;
+
+  auto const beg = std::chrono::high_resolution_clock::now();
+
+  std::vector< std::future< void > > futures;
+  for (int64_t i = 0; i < READERS_COUNT; ++i) {
+    futures.push_back( std::async(std::launch::async,
+      [&localQueue, &localMisses, &localSums, perReader, i]() {
+        int64_t hit = 0;
+        while (hit != perReader) {
+          int64_t val = 0;
+          if (localQueue.consume(val)) {
+            localSums[i] += val;
+            ++hit;
+          } else {
+            ++localMisses[i];
+            std::this_thread::yield();
+          }
+        }
+      }) );
+  }
+  for (int64_t i = 0; i < WRITERS_COUNT; ++i) {
+    futures.push_back( std::async(std::launch::async,
+      [&localQueue, perWriter]() {
+        for (int64_t j = 0; j < perWriter; ++j) {
+          localQueue.produce(j);
+        }
+      }) );
+  }
+
+  for (auto const &future : futures) {
+    future.wait();
+  }
+
+  auto const end = std::chrono::high_resolution_clock::now();
+  auto const us = std::chrono::duration_cast< std::chrono::microseconds >(
+    end - beg).count();
+
+  int64_t totalMiss = 0;
+  int64_t totalSum = 0;
+  for (int64_t i = 0; i < READERS_COUNT; ++i) {
+    totalMiss += localMisses[i];
+    totalSum += localSums[i];
+  }
+  int64_t const totalHit = perReader * READERS_COUNT;
+  BOOST_CHECK_EQUAL(WRITERS_COUNT * perWriter * (perWriter - 1) / 2, totalSum);
+
+  std::cout << aName << ": hit " << totalHit << ", miss " << totalMiss
+    << ", miss ratio " << double(totalMiss) / double(totalHit + totalMiss)
+    << ", duration " << us << " microseconds, throughput "
+    << (us ? double(totalHit) / us : 0.0) << " Mops/s" << std::endl;
+}
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(mcmp_side_by_side) {
+  runQueue< MCMPList< int64_t > >("MCMPList");
+  runQueue< MCMPLockFreeList< int64_t > >("MCMPLockFreeList");
+}
+//------------------------------------------------------------------------------
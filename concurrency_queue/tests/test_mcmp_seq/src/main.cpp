@@ -4,6 +4,7 @@
 #include <future>
 #include <iostream>
 #include "mcmp_seq.h"
+#include "mcmp_cell_seq.h"
 #include <vector>
 //------------------------------------------------------------------------------
 int64_t const TOTAL_HIT = 1000000;
@@ -49,6 +50,103 @@ BOOST_AUTO_TEST_CASE(mcmp_concurrency_push_pop) {
   }  
 }
 //------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(mcmp_cell_push_pop) {
+  int64_t const testValues[] = {1024, -45345, 0, 234, 34, -32768};
+
+  MCMPCellSeq< int64_t > queue(6);
+
+  BOOST_CHECK_EQUAL( true, queue.isEmpty() );
+  for (auto &testValue : testValues) {
+    BOOST_CHECK_EQUAL( true, queue.produce(testValue) );
+  }
+  BOOST_CHECK_EQUAL( true, queue.isFull() );
+  BOOST_CHECK_EQUAL( false, queue.produce(1) );
+
+  for (size_t i = 0, n = sizeof(testValues) / sizeof(testValues[0]); i < n;
+    ++i)
+  {
+    int64_t value = 0;
+    BOOST_CHECK_EQUAL( true, queue.consume(value) );
+    BOOST_CHECK_EQUAL(testValues[i], value);
+    BOOST_CHECK_EQUAL( true, queue.emplace(testValues[i]) );
+  }
+  BOOST_CHECK_EQUAL( 6, queue.fillCount() );
+}
+//------------------------------------------------------------------------------
+// Runs aThreads writers and aThreads readers over a small queue, so that both
+// full and empty states are hit. Returns duration in microseconds.
+template < typename Queue >
+int64_t runThreads(int64_t const aThreads, int64_t &aMiss, int64_t &aSum) {
+  int64_t const perThread = TOTAL_HIT / aThreads;
+  Queue queue(1024);
+  std::vector< int64_t > threadMisses(aThreads);
+  std::vector< int64_t > threadSums(aThreads);
+
+  auto const beg = std::chrono::high_resolution_clock::now();
+
+  std::vector< std::future< void > > futures;
+  for (int64_t t = 0; t < aThreads; ++t) {
+    futures.push_back( std::async(std::launch::async, [&queue, perThread]() {
+      for (int64_t i = 0; i < perThread; ++i) {
+        while (!queue.produce(i)) {
+          std::this_thread::yield();
+        }
+      }
+    }) );
+    futures.push_back( std::async(std::launch::async,
+      [&queue, &threadMisses, &threadSums, perThread, t]() {
+        int64_t hit = 0;
+        while (hit != perThread) {
+          int64_t val = 0;
+          if (queue.consume(val)) {
+            threadSums[t] += val;
+            ++hit;
+          } else {
+            ++threadMisses[t];
+            std::this_thread::yield();
+          }
+        }
+      }) );
+  }
+
+  for (auto const &future : futures) {
+    future.wait();
+  }
+
+  auto const end = std::chrono::high_resolution_clock::now();
+
+  aMiss = 0;
+  aSum = 0;
+  for (int64_t t = 0; t < aThreads; ++t) {
+    aMiss += threadMisses[t];
+    aSum += threadSums[t];
+  }
+
+  return std::chrono::duration_cast< std::chrono::microseconds >(end - beg)
+    .count();
+}
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(mcmp_threads_sweep) {
+  for (int64_t threads = 1; threads <= WRITERS_COUNT; ++threads) {
+    int64_t const perThread = TOTAL_HIT / threads;
+    int64_t const expectedSum = threads * perThread * (perThread - 1) / 2;
+
+    int64_t miss = 0;
+    int64_t sum = 0;
+    auto const lockedDuration = runThreads< MCMPSeq< int64_t > >(threads,
+      miss, sum);
+    BOOST_CHECK_EQUAL(expectedSum, sum);
+    std::cout << "threads " << threads << " MCMPSeq: miss " << miss
+      << ", duration " << lockedDuration << " microseconds" << std::endl;
+
+    auto const cellDuration = runThreads< MCMPCellSeq< int64_t > >(threads,
+      miss, sum);
+    BOOST_CHECK_EQUAL(expectedSum, sum);
+    std::cout << "threads " << threads << " MCMPCellSeq: miss " << miss
+      << ", duration " << cellDuration << " microseconds" << std::endl;
+  }
+}
+//------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE(scsp_concurrency) {
   auto const beg = std::chrono::high_resolution_clock::now();
 
@@ -0,0 +1,218 @@
+# ifndef _UNORDERED_RING_BAR_H_
+# define _UNORDERED_RING_BAR_H_
+//--------------------------------------------------------------------------------
+# include <cassert>
+# include <cstdint>
+# include <atomic>
+# include <chrono>
+//--------------------------------------------------------------------------------
+# include "utils/mem_utils.h"
+# include "scmp_ring_array.h"
+//--------------------------------------------------------------------------------
+//
+// The same exchange as RingBar, but the master gets elements in the order they
+// are released by visitors, not fetched. A visitor stuck with an element leaves
+// a hole the master passes by: the other elements keep going round, and the
+// stuck one comes to the master whenever it's released.
+//
+// Idle elements wait in a free ring the visitors take them from, the master
+// puts them back on release. Released elements go to the master through a SCMP
+// ring of pointers. Neither ring can overflow as both are as big as the bar.
+// A visitor preempted between claiming a slot of the released ring and filling
+// it still holds the master up, but only for these few instructions.
+//
+// 'oldest_hold( )' is the watchdog: how long the oldest of the elements fetched
+// and not yet released has been held. Visitors stamp the time on fetch for it.
+//
+// Type must have default constructor.
+//
+//--------------------------------------------------------------------------------
+namespace concur {
+//--------------------------------------------------------------------------------
+
+template < typename Type, std::size_t Alignment, typename IndexPolicy = utils::modulo_index,
+           typename StoragePolicy = utils::heap_storage >
+class UnorderedRingBar
+{
+private:
+  typedef std::chrono::steady_clock   clock_type;
+
+  struct ALIGNAS( Alignment ) Node
+  {
+    enum : uint_fast8_t { FREE, HELD, READY };
+
+    Node( const Node& )             = delete;
+    Node& operator =( const Node& ) = delete;
+
+    Node( ) : state( FREE ), fetch_time( 0 ), data( ) { }
+
+    std::atomic< uint_fast8_t >           state;
+    std::atomic< clock_type::rep >        fetch_time;
+    Type                                  data;
+  };
+
+  // a free ring slot holds a node for the fetch number 'pos' if 'seq' is 'pos + 1'
+  struct Cell
+  {
+    std::atomic< uint64_t >   seq;
+    Node*                     node;
+  };
+
+public:
+  typedef UnorderedRingBar< Type, Alignment, IndexPolicy, StoragePolicy >   this_type;
+  typedef Type                                                              element_type;
+  typedef clock_type::duration                                              duration_type;
+
+  UnorderedRingBar( const UnorderedRingBar& )             = delete;
+  UnorderedRingBar& operator =( const UnorderedRingBar& ) = delete;
+
+public:
+  UnorderedRingBar( ) : free_tail_( 0 ), free_head_( 0 ) { }
+
+  //----------------------------------------
+  // not thread-safe
+
+  void init( unsigned size )
+  {
+    ring_.init( size );
+    cells_.init( size );
+    ready_.init( size );
+
+    for( unsigned i( 0 ); i < size; ++i )
+      cells_.at( i ).seq.store( i, std::memory_order_relaxed );
+    for( unsigned i( 0 ); i < size; ++i )
+      put_free( &ring_.at( i ) );
+  }
+
+  inline element_type& at( std::size_t pos )
+  {
+    return ring_.at( static_cast< size_type >( pos ) ).data;
+  }
+
+  //----------------------------------------
+  // for visitors
+
+  element_type* visitor_fetch( )
+  {
+    Node* node = take_free( );
+    if( !node )
+      return nullptr;
+
+    node->fetch_time.store( clock_type::now( ).time_since_epoch( ).count( ), std::memory_order_relaxed );
+    node->state.store( Node::HELD, std::memory_order_release );
+    return &( node->data );
+  }
+
+  void visitor_release( const element_type* ptr )
+  {
+    Node* node = to_node( ptr );
+    node->state.store( Node::READY, std::memory_order_relaxed );
+
+    const bool pushed = ready_.push( node );
+    assert( pushed && "released ring overflow" );
+    ( void )pushed;
+  }
+
+  //----------------------------------------
+  // for master
+
+  element_type* master_fetch( )
+  {
+    Node* node = nullptr;
+    return ready_.pop( node ) ? &( node->data ) : nullptr;
+  }
+
+  void master_release( const element_type* ptr )
+  {
+    Node* node = to_node( ptr );
+    node->state.store( Node::FREE, std::memory_order_relaxed );
+    put_free( node );
+  }
+
+  void master_skip_all( )
+  {
+    while( element_type* ptr = master_fetch( ) )
+      master_release( ptr );
+  }
+
+  //----------------------------------------
+  // for any thread, walks all the elements
+
+  // Zero if nothing is held. Racy by nature: an element may be released or
+  // fetched again during the walk.
+  duration_type oldest_hold( )
+  {
+    const clock_type::rep now = clock_type::now( ).time_since_epoch( ).count( );
+    clock_type::rep oldest = now;
+    for( size_type i( 0 ); i < ring_.size( ); ++i ) {
+      Node& node = ring_.at( i );
+      if( node.state.load( std::memory_order_acquire ) == Node::HELD ) {
+        const clock_type::rep fetch_time = node.fetch_time.load( std::memory_order_relaxed );
+        if( fetch_time < oldest )
+          oldest = fetch_time;
+      }
+    }
+    return duration_type( now - oldest );
+  }
+
+private:
+  static inline Node* to_node( const element_type* ptr )
+  {
+    return const_cast< Node* >(
+          reinterpret_cast< const Node* >(
+            reinterpret_cast< const char* >( ptr ) - offsetof( Node, data )
+            )
+          );
+  }
+
+  Node* take_free( )
+  {
+    uint64_t pos = free_tail_.load( std::memory_order_relaxed );
+    for( ; ; ) {
+      Cell& cell = cells_.at( pos );
+      const int64_t diff = static_cast< int64_t >( cell.seq.load( std::memory_order_acquire ) - ( pos + 1 ) );
+      if( diff == 0 ) {
+        if( free_tail_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+          Node* node = cell.node;
+          cell.seq.store( pos + cells_.size( ), std::memory_order_release );
+          return node;
+        }
+      } else if( diff < 0 ) {
+        return nullptr; // all the elements are held or released
+      } else {
+        pos = free_tail_.load( std::memory_order_relaxed );
+      }
+    }
+  }
+
+  // the master only; waits for a visitor of the previous lap which has taken
+  // the cell and not yet handed it over
+  void put_free( Node* node )
+  {
+    const uint64_t pos = free_head_++;
+    Cell& cell = cells_.at( pos );
+    while( cell.seq.load( std::memory_order_acquire ) != pos )
+      ;
+    cell.node = node;
+    cell.seq.store( pos + 1, std::memory_order_release );
+  }
+
+  typedef uint64_t                                                            size_type;
+  typedef utils::aligned_ring< Node, size_type, IndexPolicy, StoragePolicy >  ring_type;
+  typedef utils::aligned_ring< Cell, size_type, IndexPolicy >                 cells_type;
+  typedef ScmpRingArray< Node*, Alignment, IndexPolicy >                      ready_type;
+
+private:
+  ring_type                           ring_;
+  cells_type                          cells_;
+  ready_type                          ready_;
+  ALIGNAS( Alignment )
+  std::atomic< uint64_t >             free_tail_;   // visitors take from
+  ALIGNAS( Alignment )
+  uint64_t                            free_head_;   // the master puts to
+}; // class UnorderedRingBar
+
+//--------------------------------------------------------------------------------
+} // namespace concur
+//--------------------------------------------------------------------------------
+# endif // _UNORDERED_RING_BAR_H_
@@ -0,0 +1,197 @@
+# ifndef _CONCUR_CIRCULAR_BUFFER_H_
+# define _CONCUR_CIRCULAR_BUFFER_H_
+//--------------------------------------------------------------------------------
+# include <cassert>
+# include <cstddef>
+# include <new>
+# include <utility>
+//--------------------------------------------------------------------------------
+# include "mem_utils.h"
+//--------------------------------------------------------------------------------
+namespace concur { namespace utils {
+//--------------------------------------------------------------------------------
+//
+// A FIFO in one contiguous array, a drop-in for std::queue as the storage of
+// utils::Queue. The array doubles when it's full and never shrinks, so a queue
+// swinging between empty and full stops allocating after the first swing. It
+// starts with room for 'Reserve' elements on the first push, 'reserve( )' gets
+// more up front.
+//
+// The capacity is a power of two: the positions are masked, not divided.
+//
+// Growing works as in std::vector: a new element is built in the new array
+// before the old ones move over, so 'push( front( ) )' on a full buffer is fine,
+// and the elements are moved only if that can't throw (copied otherwise), so a
+// failed growth leaves the buffer as it was. The array comes from 'operator new'
+// or, for over-aligned types, from 'aligned_malloc' as C++17 'new' would do.
+//
+//--------------------------------------------------------------------------------
+
+template < typename Type, std::size_t Reserve = 64 >
+class CircularBuffer
+{
+public:
+  typedef Type          value_type;
+  typedef std::size_t   size_type;
+
+  static_assert( Reserve && !( Reserve & ( Reserve - 1 ) ), "reserve must be a power of two" );
+
+  CircularBuffer( const CircularBuffer& )             = delete;
+  CircularBuffer& operator =( const CircularBuffer& ) = delete;
+
+public:
+  CircularBuffer( ) = default;
+
+  ~CircularBuffer( )
+  {
+    clear( );
+    deallocate( arr_ );
+  }
+
+  inline bool       empty( ) const    { return head_ == tail_; }
+  inline size_type  size( ) const     { return head_ - tail_; }
+  inline size_type  capacity( ) const { return arr_ ? mask_ + 1 : 0; }
+
+  inline value_type& front( )
+  {
+    assert( !empty( ) );
+    return arr_[ tail_ & mask_ ];
+  }
+
+  template < typename ...Args >
+  inline void emplace( Args&& ...args )
+  {
+    if( size( ) == capacity( ) ) {
+      emplace_grow( std::forward< Args >( args )... );
+      return;
+    }
+    new( arr_ + ( head_ & mask_ ) ) value_type( std::forward< Args >( args )... );
+    ++head_;
+  }
+
+  inline void push( const value_type& val ) { emplace( val ); }
+  inline void push( value_type&& val )      { emplace( std::move( val ) ); }
+
+  inline void pop( )
+  {
+    assert( !empty( ) );
+    arr_[ tail_++ & mask_ ].~value_type( );
+  }
+
+  // keeps the capacity
+  void clear( )
+  {
+    while( !empty( ) )
+      pop( );
+  }
+
+  // rounds 'count' up to a power of two
+  void reserve( size_type count )
+  {
+    size_type cap = capacity( ) ? capacity( ) : Reserve;
+    while( cap < count )
+      cap *= 2;
+    if( cap > capacity( ) ) {
+      value_type* arr = allocate( cap );
+      try {
+        move_to( arr );
+      } catch( ... ) {
+        deallocate( arr );
+        throw;
+      }
+      adopt( arr, cap );
+    }
+  }
+
+  void swap( CircularBuffer& x )
+  {
+    std::swap( arr_, x.arr_ );
+    std::swap( mask_, x.mask_ );
+    std::swap( head_, x.head_ );
+    std::swap( tail_, x.tail_ );
+  }
+
+private:
+  // the new element may refer to an old one, so it's built first
+  template < typename ...Args >
+  void emplace_grow( Args&& ...args )
+  {
+    const size_type cap   = capacity( ) ? capacity( ) * 2 : Reserve;
+    const size_type count = size( );
+    value_type* arr = allocate( cap );
+    try {
+      new( arr + count ) value_type( std::forward< Args >( args )... );
+    } catch( ... ) {
+      deallocate( arr );
+      throw;
+    }
+    try {
+      move_to( arr );
+    } catch( ... ) {
+      arr[ count ].~value_type( );
+      deallocate( arr );
+      throw;
+    }
+    adopt( arr, cap );
+    ++head_;
+  }
+
+  static const bool OVER_ALIGNED = ALIGNOF( value_type ) > ALIGNOF( std::max_align_t );
+
+  static value_type* allocate( size_type cap )
+  {
+    if( !OVER_ALIGNED )
+      return static_cast< value_type* >( ::operator new( cap * sizeof( value_type ) ) );
+    void* ptr = aligned_malloc( ALIGNOF( value_type ), cap * sizeof( value_type ) );
+    if( !ptr )
+      throw std::bad_alloc( );
+    return static_cast< value_type* >( ptr );
+  }
+
+  static void deallocate( value_type* arr )
+  {
+    if( OVER_ALIGNED )
+      aligned_free( arr );
+    else
+      ::operator delete( arr );
+  }
+
+  // moves or copies the elements to the beginning of 'arr'; if that throws, the
+  // ones built there are destroyed and the buffer is intact
+  void move_to( value_type* arr )
+  {
+    size_type i( 0 );
+    try {
+      for( ; i < size( ); ++i )
+        new( arr + i ) value_type( std::move_if_noexcept( arr_[ ( tail_ + i ) & mask_ ] ) );
+    } catch( ... ) {
+      while( i )
+        arr[ --i ].~value_type( );
+      throw;
+    }
+  }
+
+  // takes 'arr' with the elements moved to it
+  void adopt( value_type* arr, size_type cap )
+  {
+    const size_type count = size( );
+    clear( );
+    deallocate( arr_ );
+
+    arr_  = arr;
+    mask_ = cap - 1;
+    tail_ = 0;
+    head_ = count;
+  }
+
+private:
+  value_type*   arr_  = nullptr;
+  size_type     mask_ = 0;
+  size_type     head_ = 0;    // push to
+  size_type     tail_ = 0;    // pop from
+}; // class CircularBuffer
+
+//--------------------------------------------------------------------------------
+} } // namespace concur::utils
+//--------------------------------------------------------------------------------
+# endif // _CONCUR_CIRCULAR_BUFFER_H_
@@ -0,0 +1,151 @@
+# ifndef _CONCUR_EVENT_COUNT_H_
+# define _CONCUR_EVENT_COUNT_H_
+//--------------------------------------------------------------------------------
+# include <cstdint>
+# include <climits>
+# include <atomic>
+# include <chrono>
+# include <cstddef>
+# include <mutex>
+# include <condition_variable>
+//--------------------------------------------------------------------------------
+# ifdef __linux__
+#   include <ctime>
+#   include <unistd.h>
+#   include <sys/syscall.h>
+#   include <linux/futex.h>
+# endif
+//--------------------------------------------------------------------------------
+namespace concur { namespace utils {
+//--------------------------------------------------------------------------------
+//
+// Event count: lets a thread park until some condition may have changed without
+// making the notifying side pay for a syscall when nobody is parked.
+//
+// Waiter:                                 Notifier:
+//   key = prepare_wait( );                  <make condition true>
+//   if( condition ) cancel_wait( );         notify_one( ) / notify_all( );
+//   else            wait( key, dur );
+//
+// On Linux waiters park on a futex, elsewhere on a condition variable.
+//
+//--------------------------------------------------------------------------------
+
+class EventCount
+{
+public:
+  typedef uint32_t key_type;
+
+  EventCount( const EventCount& )               = delete;
+  EventCount& operator =( const EventCount& )   = delete;
+
+  EventCount( ) : epoch_( 0 ), waiters_( 0 ) { }
+
+  // registers the calling thread as a waiter; condition must be rechecked after
+  inline key_type prepare_wait( )
+  {
+    waiters_.fetch_add( 1, std::memory_order_seq_cst );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    return epoch_.load( std::memory_order_seq_cst );
+  }
+
+  // unregisters the waiter if the condition turned out to be true
+  inline void cancel_wait( )
+  {
+    waiters_.fetch_sub( 1, std::memory_order_relaxed );
+  }
+
+  // parks until notified after 'key' was taken or 'dur' expired; unregisters
+  template < class Rep, class Period >
+  void wait( key_type key, const std::chrono::duration< Rep, Period > dur )
+  {
+    park( key, std::chrono::duration_cast< std::chrono::nanoseconds >( dur ) );
+    waiters_.fetch_sub( 1, std::memory_order_relaxed );
+  }
+
+  inline void notify_one( ) { notify( 1 ); }
+  inline void notify_all( ) { notify( INT_MAX ); }
+
+  inline unsigned waiters( ) const
+  {
+    return waiters_.load( std::memory_order_relaxed );
+  }
+
+private:
+  inline void notify( int count )
+  {
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if( waiters_.load( std::memory_order_relaxed ) )
+      wake( count );
+  }
+
+# ifdef __linux__
+  void park( key_type key, std::chrono::nanoseconds dur )
+  {
+    if( dur.count( ) <= 0 )
+      return;
+    timespec ts;
+    ts.tv_sec   = static_cast< time_t >( dur.count( ) / 1000000000 );
+    ts.tv_nsec  = static_cast< long >( dur.count( ) % 1000000000 );
+    syscall( SYS_futex, futex_addr( ), FUTEX_WAIT_PRIVATE, key, &ts, nullptr, 0 );
+  }
+
+  void wake( int count )
+  {
+    epoch_.fetch_add( 1, std::memory_order_seq_cst );
+    syscall( SYS_futex, futex_addr( ), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0 );
+  }
+
+  inline int* futex_addr( )
+  {
+    static_assert( sizeof( epoch_ ) == sizeof( int ), "futex word must be 32-bit" );
+    return reinterpret_cast< int* >( &epoch_ );
+  }
+# else
+  void park( key_type key, std::chrono::nanoseconds dur )
+  {
+    std::unique_lock< std::mutex > lock( mtx_ );
+    cv_.wait_for( lock, dur, [ & ]( ) {
+      return epoch_.load( std::memory_order_relaxed ) != key;
+    } );
+  }
+
+  void wake( int count )
+  {
+    {
+      std::lock_guard< std::mutex > lock( mtx_ );
+      epoch_.fetch_add( 1, std::memory_order_seq_cst );
+    }
+    if( count == 1 )
+      cv_.notify_one( );
+    else
+      cv_.notify_all( );
+  }
+
+  std::mutex                  mtx_;
+  std::condition_variable     cv_;
+# endif
+
+  std::atomic< key_type >     epoch_;
+  std::atomic< unsigned >     waiters_;
+}; // class EventCount
+
+//--------------------------------------------------------------------------------
+
+// For containers counting their waiters under the mutex themselves: wakes one
+// of 'waiters' parked on 'cv' per each of 'count' new elements, all of them with
+// a single call if there are enough elements. Meant to be called after unlocking.
+inline void notify_waiters( std::condition_variable& cv, std::size_t count, unsigned waiters )
+{
+  if( !count || !waiters )
+    return;
+  if( count >= waiters )
+    cv.notify_all( );
+  else
+    while( count-- ) cv.notify_one( );
+}
+
+//--------------------------------------------------------------------------------
+} } // namespace concur::utils
+//--------------------------------------------------------------------------------
+# endif // _CONCUR_EVENT_COUNT_H_
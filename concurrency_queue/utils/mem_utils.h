@@ -2,8 +2,11 @@
 # define _CONCUR_MEM_UTILS_H_
 //--------------------------------------------------------------------------------
 # include <cstdint>
+# include <cstddef>
 # include <cstdlib>
 # include <cassert>
+# include <memory>
+# include <new>
 # include <stdexcept>
 //--------------------------------------------------------------------------------
 # ifdef _MSC_VER 
@@ -22,16 +25,199 @@
 #   define aligned_malloc( A, S )   memalign( A, S )
 #   define aligned_free( PTR )      std::free( PTR )
 # endif
+# ifdef __linux__
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+# endif
 //--------------------------------------------------------------------------------
 namespace concur { namespace utils {
 //--------------------------------------------------------------------------------
+// Index policies map an ever-growing ring position onto a storage index.
+
+// Storage of any size; costs an integer division per access.
+struct modulo_index
+{
+  inline void init( std::size_t size ) { size_ = size; }
+  
+  template < typename SizeType >
+  inline SizeType operator ()( SizeType i ) const {
+    return static_cast< SizeType >( i % size_ );
+  }
+  
+private:
+  std::size_t size_ = 1;
+};
 
-template < typename ElementType, typename SizeType >
+// Storage size must be a power of two; costs a single AND per access. Also keeps
+// positions continuous when a position counter wraps around.
+struct pow2_index
+{
+  inline void init( std::size_t size )
+  {
+    if( !size || ( size & ( size - 1 ) ) )
+      throw std::invalid_argument( "ring size must be a power of two" );
+    mask_ = size - 1;
+  }
+  
+  template < typename SizeType >
+  inline SizeType operator ()( SizeType i ) const {
+    return static_cast< SizeType >( i & mask_ );
+  }
+  
+private:
+  std::size_t mask_ = 0;
+};
+
+//--------------------------------------------------------------------------------
+// Storage policies allocate the single block of a ring (or of a slab). An
+// instance serves one block at a time.
+
+// Regular heap block.
+struct heap_storage
+{
+  inline void* allocate( std::size_t alignment, std::size_t size ) {
+    return aligned_malloc( alignment, size );
+  }
+  inline void deallocate( void* ptr, std::size_t ) {
+    aligned_free( ptr );
+  }
+};
+
+// Anonymous mapping of its own, so the block doesn't share pages with anything
+// else. With 'HugePages' it tries MAP_HUGETLB first and then asks for
+// transparent huge pages. With 'NumaNode' >= 0 the pages are bound to that node
+// before the first touch. Every step falls back quietly: no huge pages, no
+// binding, and finally the heap (also for alignments above the page size and on
+// systems without mmap).
+template < bool HugePages = true, int NumaNode = -1 >
+class mapped_storage
+{
+public:
+  static_assert( NumaNode < 64, "NUMA node out of the supported range" );
+  
+  void* allocate( std::size_t alignment, std::size_t size )
+  {
+    assert( !ptr_ && "one block per storage" );
+# ifdef __linux__
+    const std::size_t page_size = static_cast< std::size_t >( sysconf( _SC_PAGESIZE ) );
+    if( alignment <= page_size && size ) {
+      void* ptr = MAP_FAILED;
+#   ifdef MAP_HUGETLB
+      if( HugePages ) {
+        length_ = round_up( size, HUGE_PAGE_SIZE );
+        ptr = mmap( nullptr, length_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+        huge_ = ( ptr != MAP_FAILED );
+      }
+#   endif
+      if( ptr == MAP_FAILED ) {
+        length_ = round_up( size, page_size );
+        ptr = mmap( nullptr, length_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+#   ifdef MADV_HUGEPAGE
+        if( HugePages && ptr != MAP_FAILED )
+          madvise( ptr, length_, MADV_HUGEPAGE );
+#   endif
+      }
+      if( ptr != MAP_FAILED ) {
+#   ifdef SYS_mbind
+        if( NumaNode >= 0 ) {
+          const int           MPOL_BIND_MODE  = 2; // MPOL_BIND from numaif.h
+          const unsigned long mask            = 1ul << ( NumaNode < 0 ? 0 : NumaNode );
+          bound_ = !syscall( SYS_mbind, ptr, length_, MPOL_BIND_MODE, &mask, sizeof( mask ) * 8, 0 );
+        }
+#   endif
+        mapped_ = true;
+        return ptr_ = ptr;
+      }
+    }
+# endif
+    return ptr_ = aligned_malloc( alignment, size );
+  }
+  
+  void deallocate( void* ptr, std::size_t )
+  {
+    if( !ptr )
+      return;
+    assert( ptr == ptr_ );
+# ifdef __linux__
+    if( mapped_ )
+      munmap( ptr, length_ );
+    else
+# endif
+      aligned_free( ptr );
+    ptr_    = nullptr;
+    mapped_ = huge_ = bound_ = false;
+  }
+  
+  // how the current block is backed
+  inline bool mapped( ) const     { return mapped_; }
+  inline bool huge_pages( ) const { return huge_; }   // MAP_HUGETLB, not THP
+  inline bool numa_bound( ) const { return bound_; }
+  
+private:
+  static const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+  
+  static inline std::size_t round_up( std::size_t size, std::size_t page ) {
+    return ( size + page - 1 ) / page * page;
+  }
+  
+  void*         ptr_    = nullptr;
+  std::size_t   length_ = 0;
+  bool          mapped_ = false;
+  bool          huge_   = false;
+  bool          bound_  = false;
+};
+
+//--------------------------------------------------------------------------------
+// Arrays of over-aligned types ('ALIGNAS( 64 )' padding against false sharing):
+// plain 'new' honours such alignment only since C++17.
+
+template < typename Type >
+struct aligned_array_deleter
+{
+  std::size_t count = 0;
+  
+  void operator ()( Type* arr ) const
+  {
+    for( std::size_t i( count ); i; )
+      arr[ --i ].~Type( );
+    aligned_free( arr );
+  }
+};
+
+template < typename Type >
+using aligned_array = std::unique_ptr< Type[ ], aligned_array_deleter< Type > >;
+
+// 'count' default-constructed elements aligned for 'Type'
+template < typename Type >
+aligned_array< Type > make_aligned_array( std::size_t count )
+{
+  Type* arr = static_cast< Type* >( aligned_malloc( ALIGNOF( Type ), sizeof( Type ) * count ) );
+  if( !arr )
+    throw std::bad_alloc( );
+  
+  aligned_array_deleter< Type > deleter;
+  try {
+    for( ; deleter.count < count; ++deleter.count )
+      new( arr + deleter.count ) Type;
+  } catch( ... ) {
+    deleter( arr );
+    throw;
+  }
+  return aligned_array< Type >( arr, deleter );
+}
+
+//--------------------------------------------------------------------------------
+
+template < typename ElementType, typename SizeType, typename IndexPolicy = modulo_index,
+           typename StoragePolicy = heap_storage >
 class aligned_ring
 {
 public:
-  typedef ElementType   element_type;
-  typedef SizeType      size_type;
+  typedef ElementType     element_type;
+  typedef SizeType        size_type;
+  typedef IndexPolicy     index_policy;
+  typedef StoragePolicy   storage_policy;
   
   aligned_ring( const aligned_ring& )               = delete;
   aligned_ring& operator =( const aligned_ring& )   = delete;
@@ -43,15 +229,16 @@ public:
   {
     for( size_type i( 0 ); i < arr_size_; ++i )
       arr_[ i ].~element_type( );
-    aligned_free( arr_ );
+    storage_.deallocate( arr_, sizeof( element_type ) * arr_size_ );
   }
   
   void init( size_type size )
   {
     assert( ( arr_ == nullptr ) && "ring already initialized" );
     
+    index_.init( size );
     arr_ = static_cast< element_type* >(
-             aligned_malloc( ALIGNOF( element_type ), sizeof( element_type ) * size )
+             storage_.allocate( ALIGNOF( element_type ), sizeof( element_type ) * size )
              );
     
     if( !arr_ )
@@ -62,13 +249,17 @@ public:
       new( arr_ + i ) element_type;
   }
   
-  inline element_type& at( size_type i ) { return arr_[ i % arr_size_ ]; }
+  inline element_type& at( size_type i ) { return arr_[ index_( i ) ]; }
   
   inline size_type size( ) const { return arr_size_; }
+  
+  inline const storage_policy& storage( ) const { return storage_; }
 
 private:
   element_type*   arr_        = nullptr;
   size_type       arr_size_   = 0;
+  index_policy    index_;
+  storage_policy  storage_;
 }; // class aligned_ring
 
 //--------------------------------------------------------------------------------
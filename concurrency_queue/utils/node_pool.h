@@ -0,0 +1,184 @@
+# ifndef _CONCUR_NODE_POOL_H_
+# define _CONCUR_NODE_POOL_H_
+//--------------------------------------------------------------------------------
+# include <cstddef>
+# include <cstdint>
+# include <atomic>
+# include <new>
+//--------------------------------------------------------------------------------
+# include "mem_utils.h"
+//--------------------------------------------------------------------------------
+namespace concur { namespace utils {
+//--------------------------------------------------------------------------------
+// Node policies provide raw memory for nodes of linked containers. A policy has
+// a nested 'pool< NodeT >' with:
+//   void* take( );          - memory for one node, may be called by any thread
+//   void  give( void* );    - returns memory, called by a single thread only
+//   void  give_chain( void* first, std::size_t count );
+//                           - returns 'count' blocks at once, linked through
+//                             their first word (see 'chain_next'), called by the
+//                             same single thread as 'give'
+//   void  discard( void* ); - returns memory straight to the heap behind the
+//                             policy, may be called by any thread (e.g. by a
+//                             producer whose node constructor has thrown)
+
+// The link of a released block to the next one in a chain.
+inline void*& chain_next( void* ptr ) { return *static_cast< void** >( ptr ); }
+
+// Every node comes from and goes back to the heap: '::operator new' or, for
+// over-aligned nodes, 'aligned_malloc', as C++17 'new' would do.
+struct heap_nodes
+{
+  template < typename NodeT >
+  struct pool
+  {
+    static const bool OVER_ALIGNED = ALIGNOF( NodeT ) > ALIGNOF( std::max_align_t );
+
+    inline void* take( )
+    {
+      if( !OVER_ALIGNED )
+        return ::operator new( sizeof( NodeT ) );
+      void* ptr = aligned_malloc( ALIGNOF( NodeT ), sizeof( NodeT ) );
+      if( !ptr )
+        throw std::bad_alloc( );
+      return ptr;
+    }
+
+    inline void give( void* ptr )
+    {
+      if( OVER_ALIGNED )
+        aligned_free( ptr );
+      else
+        ::operator delete( ptr );
+    }
+
+    inline void discard( void* ptr ) { give( ptr ); }
+
+    void give_chain( void* first, std::size_t count )
+    {
+      for( ; count; --count ) {
+        void* const next = chain_next( first );
+        give( first );
+        first = next;
+      }
+    }
+  };
+};
+
+// Up to 'Capacity' released nodes are cached in a ring and handed out again,
+// so a container in steady state doesn't touch the heap. Nodes which don't fit
+// into the ring go back to the heap; takers fall back to the heap when the ring
+// is empty. The heap is 'HeapPolicy', another policy of this kind.
+//
+// Takers claim cells with a CAS on the tail, every cell carries a sequence
+// number telling whether it's filled, so a cell can't be taken twice (no ABA).
+template < std::size_t Capacity = 1024, typename HeapPolicy = heap_nodes >
+struct recycled_nodes
+{
+  static_assert( Capacity > 0, "capacity must be positive" );
+
+  template < typename NodeT >
+  class pool
+  {
+  public:
+    pool( const pool& )             = delete;
+    pool& operator =( const pool& ) = delete;
+
+    pool( )
+      : head_( 0 ), tail_( 0 )
+    {
+      for( std::size_t i( 0 ); i < Capacity; ++i ) {
+        cells_[ i ].sequence.store( i, std::memory_order_relaxed );
+        cells_[ i ].ptr = nullptr;
+      }
+    }
+
+    ~pool( )
+    {
+      while( void* ptr = take_cached( ) )
+        heap_.give( ptr );
+    }
+
+    inline void* take( )
+    {
+      void* ptr = take_cached( );
+      return ptr ? ptr : heap_.take( );
+    }
+
+    void give( void* ptr )
+    {
+      Cell& cell = cells_[ head_ % Capacity ];
+      if( cell.sequence.load( std::memory_order_acquire ) != head_ ) {
+        heap_.give( ptr ); // the cache is full
+        return;
+      }
+      cell.ptr = ptr;
+      cell.sequence.store( head_ + 1, std::memory_order_release );
+      ++head_;
+    }
+
+    // bypasses the cache, so any thread may call it
+    inline void discard( void* ptr ) { heap_.discard( ptr ); }
+
+    // fills the cells in one pass, what doesn't fit goes to the heap
+    void give_chain( void* first, std::size_t count )
+    {
+      std::size_t head = head_;
+      for( ; count; --count ) {
+        Cell& cell = cells_[ head % Capacity ];
+        if( cell.sequence.load( std::memory_order_acquire ) != head )
+          break;
+        void* const next = chain_next( first );
+        cell.ptr = first;
+        cell.sequence.store( head + 1, std::memory_order_release );
+        ++head;
+        first = next;
+      }
+      head_ = head;
+      if( count )
+        heap_.give_chain( first, count );
+    }
+
+  private:
+    void* take_cached( )
+    {
+      std::size_t pos = tail_.load( std::memory_order_relaxed );
+      Cell* cell = nullptr;
+      for( ;; ) {
+        cell = &cells_[ pos % Capacity ];
+        const std::size_t sequence = cell->sequence.load( std::memory_order_acquire );
+        const std::intptr_t diff = static_cast< std::intptr_t >( sequence - ( pos + 1 ) );
+        if( diff == 0 ) {
+          if( tail_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+            break;
+        } else if( diff < 0 ) {
+          return nullptr; // the cache is empty
+        } else {
+          pos = tail_.load( std::memory_order_relaxed );
+        }
+      }
+
+      void* ptr = cell->ptr;
+      cell->sequence.store( pos + Capacity, std::memory_order_release );
+      return ptr;
+    }
+
+    struct Cell
+    {
+      std::atomic< std::size_t >  sequence;
+      void*                       ptr;
+    };
+
+    typedef typename HeapPolicy::template pool< NodeT > heap_type;
+
+    heap_type                               heap_;
+    Cell                                    cells_[ Capacity ];
+    ALIGNAS( 64 ) std::size_t               head_; // used only by the giver
+    ALIGNAS( 64 ) std::atomic< std::size_t > tail_;
+  }; // class pool
+};
+
+//--------------------------------------------------------------------------------
+} } // namespace concur::utils
+//--------------------------------------------------------------------------------
+# endif // _CONCUR_NODE_POOL_H_
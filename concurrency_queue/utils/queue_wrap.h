@@ -4,6 +4,9 @@
 # define _QUEUE_WRAP_H_
 //--------------------------------------------------------------------------------
 # include <queue>
+# include <limits>
+//--------------------------------------------------------------------------------
+# include "circular_buffer.h"
 //--------------------------------------------------------------------------------
 namespace concur { namespace utils {
 //--------------------------------------------------------------------------------
@@ -30,6 +33,11 @@ struct queue_pusher
     }
     return false;
   }
+  
+  template < typename QueueT >
+  inline std::size_t room( const QueueT& queue ) const {
+    return ( queue.size( ) < limit ) ? ( limit - queue.size( ) ) : 0;
+  }
 };
 
 // Inserts item into a given queue always.
@@ -43,18 +51,39 @@ struct queue_pusher< false >
     queue.emplace( std::forward< T >( val ) );
     return true;
   }
+  
+  template < typename QueueT >
+  inline std::size_t room( const QueueT& ) const {
+    return ( std::numeric_limits< std::size_t >::max )( );
+  }
 };
 
+// Empties the storage: with its own 'clear', which keeps the memory (e.g.
+// CircularBuffer), or by a swap with an empty one (std::queue).
+template < typename QueueT >
+inline auto clear_queue( QueueT& queue, int ) -> decltype( queue.clear( ), void( ) ) {
+  queue.clear( );
+}
+
+template < typename QueueT >
+inline void clear_queue( QueueT& queue, long ) {
+  QueueT tmp;
+  queue.swap( tmp );
+}
+
 //--------------------------------------------------------------------------------
 } // namespace details
 //--------------------------------------------------------------------------------
 
-template < typename Type, bool Limited = false >
+// 'StorageType' is std::queue or anything with its 'empty', 'size', 'front',
+// 'emplace', 'pop' and 'swap', e.g. CircularBuffer. Its 'clear', if any, is
+// used by 'clear'.
+template < typename Type, bool Limited = false, typename StorageType = std::queue< Type > >
 class Queue : private details::queue_pusher< Limited >
 {
 public:
   typedef Type                              element_type;
-  typedef std::queue< element_type >        queue_type;
+  typedef StorageType                       queue_type;
   typedef typename queue_type::size_type    size_type;
   
   Queue( ) : max_( 0 ) { }
@@ -78,12 +107,35 @@ public:
     return false;
   }
   
+  // copies elements till the limit, returns the first one left out
+  template < typename InputIt >
+  inline InputIt push_range( InputIt first, InputIt last ) {
+    for( std::size_t room = pusher_type::room( queue_ ); room && ( first != last ); --room, ++first )
+      queue_.emplace( *first );
+    return first;
+  }
+  
+  // moves up to 'max' elements out, returns their count
+  template < typename OutputIt >
+  inline size_type pop_into( OutputIt dst, size_type max ) {
+    size_type count = 0;
+    for( ; count < max && !queue_.empty( ); ++count, ++dst ) {
+      *dst = std::move( queue_.front( ) );
+      queue_.pop( );
+    }
+    return count;
+  }
+  
   inline void clear( ) {
-    queue_type tmp;
-    queue_.swap( tmp );
+    details::clear_queue( queue_, 0 );
+  }
+  
+  // exchanges the elements only, the limits stay
+  inline void swap( Queue& x ) {
+    queue_.swap( x.queue_ );
   }
   
-  inline size_type size( ) {
+  inline size_type size( ) const {
     return queue_.size( );
   }
   
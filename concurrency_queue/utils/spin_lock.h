@@ -0,0 +1,230 @@
+# ifndef _CONCUR_SPIN_LOCK_H_
+# define _CONCUR_SPIN_LOCK_H_
+//--------------------------------------------------------------------------------
+# include <cstdint>
+# include <atomic>
+# include <thread>
+//--------------------------------------------------------------------------------
+# if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+#   include <intrin.h>
+# endif
+# ifdef __linux__
+#   include <unistd.h>
+#   include <sys/syscall.h>
+#   include <linux/futex.h>
+# endif
+//--------------------------------------------------------------------------------
+namespace concur { namespace utils {
+//--------------------------------------------------------------------------------
+//
+// Locks for the short critical sections of Queue and RingArray, any of them
+// fits their 'MutexType':
+//
+//    TtasSpinLock    test-and-test-and-set, waiters spin on a plain load with an
+//                    exponential backoff;
+//    TicketLock      FIFO: a waiter takes a ticket and spins until it's served,
+//                    backing off in proportion to its place in the line;
+//    AdaptiveLock    spins for about as long as it took to get the lock lately,
+//                    then parks on a futex (yields where there is no futex).
+//
+// The spinning ones yield the CPU once the backoff is at its maximum, so they
+// don't burn whole time slices when there are more threads than cores. Still a
+// ticket lock hands the lock over to a preempted waiter as well, so it's for
+// threads pinned to their own cores.
+//
+//--------------------------------------------------------------------------------
+
+// tells the CPU the thread is spinning
+inline void cpu_relax( )
+{
+# if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+  _mm_pause( );
+# elif defined( __i386__ ) || defined( __x86_64__ )
+  __builtin_ia32_pause( );
+# elif defined( __aarch64__ ) || defined( __arm__ )
+  __asm__ __volatile__( "yield" );
+# endif
+}
+
+// pauses for 1, 2, 4 ... 'MaxSpan' times, then yields every time
+template < unsigned MaxSpan >
+class Backoff
+{
+public:
+  inline void operator ()( )
+  {
+    if( span_ < MaxSpan ) {
+      for( unsigned i( 0 ); i < span_; ++i )
+        cpu_relax( );
+      span_ <<= 1;
+    } else {
+      std::this_thread::yield( );
+    }
+  }
+
+private:
+  unsigned span_ = 1;
+};
+
+//--------------------------------------------------------------------------------
+
+template < unsigned MaxBackoff = 1024 >
+class TtasSpinLock
+{
+public:
+  TtasSpinLock( const TtasSpinLock& )             = delete;
+  TtasSpinLock& operator =( const TtasSpinLock& ) = delete;
+
+  TtasSpinLock( ) : locked_( false ) { }
+
+  void lock( )
+  {
+    Backoff< MaxBackoff > backoff;
+    while( locked_.exchange( true, std::memory_order_acquire ) ) {
+      do {
+        backoff( );
+      } while( locked_.load( std::memory_order_relaxed ) );
+    }
+  }
+
+  inline bool try_lock( )
+  {
+    return !locked_.load( std::memory_order_relaxed ) &&
+           !locked_.exchange( true, std::memory_order_acquire );
+  }
+
+  inline void unlock( )
+  {
+    locked_.store( false, std::memory_order_release );
+  }
+
+private:
+  std::atomic< bool > locked_;
+}; // class TtasSpinLock
+
+//--------------------------------------------------------------------------------
+
+template < unsigned SpinLimit = 64 >
+class TicketLock
+{
+public:
+  TicketLock( const TicketLock& )             = delete;
+  TicketLock& operator =( const TicketLock& ) = delete;
+
+  TicketLock( ) : next_( 0 ), serving_( 0 ) { }
+
+  void lock( )
+  {
+    const uint32_t ticket = next_.fetch_add( 1, std::memory_order_relaxed );
+    for( unsigned spins( 0 ); ; ++spins ) {
+      const uint32_t serving = serving_.load( std::memory_order_acquire );
+      if( serving == ticket )
+        return;
+
+      if( spins < SpinLimit ) {
+        for( uint32_t i( ticket - serving ); i; --i )
+          cpu_relax( );
+      } else {
+        std::this_thread::yield( );
+      }
+    }
+  }
+
+  inline bool try_lock( )
+  {
+    uint32_t ticket = serving_.load( std::memory_order_relaxed );
+    return next_.compare_exchange_strong( ticket, ticket + 1, std::memory_order_acquire,
+                                          std::memory_order_relaxed );
+  }
+
+  // the holder is the only writer
+  inline void unlock( )
+  {
+    serving_.store( serving_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+  }
+
+private:
+  std::atomic< uint32_t > next_;
+  std::atomic< uint32_t > serving_;
+}; // class TicketLock
+
+//--------------------------------------------------------------------------------
+
+// The state is 0 if free, 1 if locked, 2 if locked and someone may be parked.
+// The spin limit follows the spins the lock took lately, so the spinning stops
+// early where the holders keep it for long.
+template < unsigned MaxSpin = 1000 >
+class AdaptiveLock
+{
+public:
+  AdaptiveLock( const AdaptiveLock& )             = delete;
+  AdaptiveLock& operator =( const AdaptiveLock& ) = delete;
+
+  AdaptiveLock( ) : state_( FREE ), spin_estimate_( 0 ) { }
+
+  void lock( )
+  {
+    if( try_lock( ) )
+      return;
+
+    const int estimate = spin_estimate_.load( std::memory_order_relaxed );
+    const int limit    = ( estimate * 2 + 10 < int( MaxSpin ) ) ? ( estimate * 2 + 10 ) : int( MaxSpin );
+    for( int spins( 1 ); spins <= limit; ++spins ) {
+      cpu_relax( );
+      if( state_.load( std::memory_order_relaxed ) == FREE && try_lock( ) ) {
+        spin_estimate_.store( estimate + ( spins - estimate ) / 8, std::memory_order_relaxed );
+        return;
+      }
+    }
+    spin_estimate_.store( estimate + ( limit - estimate ) / 8, std::memory_order_relaxed );
+
+    while( state_.exchange( CONTENDED, std::memory_order_acquire ) != FREE )
+      park( );
+  }
+
+  inline bool try_lock( )
+  {
+    uint32_t state = FREE;
+    return state_.compare_exchange_strong( state, LOCKED, std::memory_order_acquire,
+                                           std::memory_order_relaxed );
+  }
+
+  inline void unlock( )
+  {
+    if( state_.exchange( FREE, std::memory_order_release ) == CONTENDED )
+      wake( );
+  }
+
+private:
+  enum : uint32_t { FREE, LOCKED, CONTENDED };
+
+# ifdef __linux__
+  inline void park( )
+  {
+    syscall( SYS_futex, futex_addr( ), FUTEX_WAIT_PRIVATE, CONTENDED, nullptr, nullptr, 0 );
+  }
+
+  inline void wake( )
+  {
+    syscall( SYS_futex, futex_addr( ), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0 );
+  }
+
+  inline int* futex_addr( )
+  {
+    static_assert( sizeof( state_ ) == sizeof( int ), "futex word must be 32-bit" );
+    return reinterpret_cast< int* >( &state_ );
+  }
+# else
+  inline void park( ) { std::this_thread::yield( ); }
+  inline void wake( ) { }
+# endif
+
+private:
+  std::atomic< uint32_t > state_;
+  std::atomic< int >      spin_estimate_;
+}; // class AdaptiveLock
+
+//--------------------------------------------------------------------------------
+} } // namespace concur::utils
+//--------------------------------------------------------------------------------
+# endif // _CONCUR_SPIN_LOCK_H_
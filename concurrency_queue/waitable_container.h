@@ -0,0 +1,122 @@
+# ifndef _WAITABLE_CONTAINER_H_
+# define _WAITABLE_CONTAINER_H_
+//--------------------------------------------------------------------------------
+# include <atomic>
+# include <chrono>
+# include <utility>
+//--------------------------------------------------------------------------------
+# include "utils/mem_utils.h"
+# include "utils/event_count.h"
+//--------------------------------------------------------------------------------
+//
+// Adds blocking 'push( src, duration )' and 'pop( dst, duration )' to a
+// non-blocking container (ScspRingArray, ScmpRingArray, ScmpQueue, ...).
+//
+// A blocked call first retries the operation 'SpinCount' times and only then
+// parks the thread. Successful operations wake a parked thread of the opposite
+// side; the wakeup syscall is issued only if someone is actually parked.
+//
+// The container is used as is, so its thread restrictions stay (e.g. only one
+// consumer for ScmpRingArray). A failed 'push' must not consume the source.
+//
+//--------------------------------------------------------------------------------
+namespace concur {
+//--------------------------------------------------------------------------------
+
+template < typename ContainerT, unsigned SpinCount = 128 >
+class WaitableContainer
+{
+public:
+  typedef ContainerT container_type;
+
+  WaitableContainer( const WaitableContainer& )               = delete;
+  WaitableContainer& operator =( const WaitableContainer& )   = delete;
+
+  WaitableContainer( ) = default;
+
+  template < typename ...Args >
+  inline void init( Args&& ...args )
+  {
+    cont_.init( std::forward< Args >( args )... );
+  }
+
+  template < typename T >
+  bool push( T&& src )
+  {
+    if( cont_.push( std::forward< T >( src ) ) ) {
+      not_empty_.notify_one( );
+      return true;
+    }
+    return false;
+  }
+
+  template < typename T, class Rep, class Period >
+  bool push( T&& src, const std::chrono::duration< Rep, Period > dur )
+  {
+    return wait( not_full_, dur, [ & ]( ) { return push( std::forward< T >( src ) ); } );
+  }
+
+  template < typename T >
+  bool pop( T& dst )
+  {
+    if( cont_.pop( dst ) ) {
+      not_full_.notify_one( );
+      return true;
+    }
+    return false;
+  }
+
+  template < typename T, class Rep, class Period >
+  bool pop( T& dst, const std::chrono::duration< Rep, Period > dur )
+  {
+    return wait( not_empty_, dur, [ & ]( ) { return pop( dst ); } );
+  }
+
+  template < typename T >
+  inline bool pop( T& dst, unsigned microsec_dur )
+  {
+    return pop( dst, std::chrono::microseconds( microsec_dur ) );
+  }
+
+  // number of currently parked consumers and producers
+  inline unsigned consumer_waiters( ) const { return not_empty_.waiters( ); }
+  inline unsigned producer_waiters( ) const { return not_full_.waiters( ); }
+
+private:
+  typedef utils::EventCount event_type;
+
+  template < class Rep, class Period, typename Func >
+  static bool wait( event_type& event, const std::chrono::duration< Rep, Period > dur, Func try_op )
+  {
+    for( unsigned i( 0 ); i < SpinCount; ++i ) {
+      if( try_op( ) )
+        return true;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now( ) + dur;
+    for( ;; ) {
+      const event_type::key_type key = event.prepare_wait( );
+      if( try_op( ) ) {
+        event.cancel_wait( );
+        return true;
+      }
+
+      const auto now = std::chrono::steady_clock::now( );
+      if( now >= deadline ) {
+        event.cancel_wait( );
+        return false;
+      }
+      event.wait( key, deadline - now );
+    }
+  }
+
+private:
+  container_type                    cont_;
+  ALIGNAS( 64 ) event_type          not_empty_;   // consumers park here
+  ALIGNAS( 64 ) event_type          not_full_;    // producers park here
+}; // class WaitableContainer
+
+//--------------------------------------------------------------------------------
+} // namespace concur
+//--------------------------------------------------------------------------------
+# endif // _WAITABLE_CONTAINER_H_
@@ -0,0 +1,219 @@
+# ifndef _MCMR_BUFFER_POOL_H_
+# define _MCMR_BUFFER_POOL_H_
+//--------------------------------------------------------------------------------
+# include <cassert>
+# include <cstdint>
+# include <cstddef>
+# include <atomic>
+# include <new>
+# include <stdexcept>
+//--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
+//--------------------------------------------------------------------------------
+# include "scmr_buffer_pool.h"
+//--------------------------------------------------------------------------------
+namespace concpool {
+//--------------------------------------------------------------------------------
+//
+// Buffers for any number of allocating and releasing threads. Every thread
+// keeps a cache of up to 'CacheSize' buffers of one pool: 'pop( )' takes from
+// it and refills half of it from the shared list when it's empty, 'release( )'
+// puts to it and spills half of it to the shared list when it's full. So idle
+// buffers move between threads through the shared list in batches.
+//
+// The shared list is a stack of nodes carved out of one slab, its head is the
+// node index with a tag against ABA. Popping reads 'next' of a node that may be
+// taken by another thread meanwhile, which is harmless as the slab lives as
+// long as the pool and the tag fails the CAS.
+//
+// Cached buffers are invisible to other threads, so the pool must have more
+// than 'threads * CacheSize' buffers to never run dry for good. A thread
+// dealing with another pool of the same type uses the shared list of that
+// pool directly while its cache holds buffers of the first one. Every thread
+// must 'flush( )' or exit before the pool is destroyed.
+//
+//--------------------------------------------------------------------------------
+
+template < unsigned CacheSize = 64 >
+class McmrBufferPool
+{
+public:
+  static_assert( CacheSize >= 2, "cache must hold at least 2 buffers" );
+
+  McmrBufferPool( const McmrBufferPool& )             = delete;
+  McmrBufferPool& operator =( const McmrBufferPool& ) = delete;
+
+  static void release( void* ptr )
+  {
+    assert( ptr );
+
+    node_type*      node = static_cast< node_type* >( ptr ) - 1;
+    McmrBufferPool* pool = static_cast< McmrBufferPool* >( node->pool );
+
+    Cache& c = cache( );
+    if( c.pool != pool ) {
+      if( c.count ) {
+        pool->push_shared( &node, 1 );
+        return;
+      }
+      c.pool = pool;
+    }
+
+    if( c.count == CacheSize ) {
+      c.count -= CacheSize / 2;
+      pool->push_shared( c.nodes + c.count, CacheSize / 2 );
+    }
+    c.nodes[ c.count++ ] = node;
+  }
+
+  // returns the calling thread's cache to the shared list of its pool
+  static void flush( )
+  {
+    cache( ).flush( );
+  }
+
+public:
+  McmrBufferPool( ) = default;
+  ~McmrBufferPool( )
+  {
+    Cache& c = cache( );
+    if( c.pool == this ) {
+      c.count = 0;
+      c.pool  = nullptr;
+    }
+    aligned_free( slab_ );
+  }
+
+  void init( std::size_t count, std::size_t payload_size )
+  {
+    if( slab_ )
+      throw std::logic_error( "pool already initialized" );
+    if( !count || count >= INDEX_MASK )
+      throw std::invalid_argument( "bad pool size" );
+
+    const std::size_t align = ALIGNOF( std::max_align_t );
+    stride_ = ( sizeof( node_type ) + payload_size + align - 1 ) / align * align;
+    slab_   = static_cast< char* >( aligned_malloc( 64, stride_ * count ) );
+    if( !slab_ )
+      throw std::bad_alloc( );
+    count_ = count;
+
+    // link all the nodes into the shared list
+    for( std::size_t i( 0 ); i < count; ++i ) {
+      node_type* next = ( i + 1 < count ) ? node_at( i + 2 ) : nullptr;
+      new( slab_ + i * stride_ ) node_type( this );
+      node_at( i + 1 )->next.store( next, std::memory_order_relaxed );
+    }
+    head_.store( make_head( 1, 0 ), std::memory_order_release );
+  }
+
+  void* pop( )
+  {
+    Cache& c = cache( );
+    if( c.pool != this ) {
+      if( c.count ) {
+        node_type* node = pop_shared( );
+        return node ? ( node + 1 ) : nullptr;
+      }
+      c.pool = this;
+    }
+
+    if( !c.count ) {
+      while( c.count < CacheSize / 2 ) {
+        node_type* node = pop_shared( );
+        if( !node )
+          break;
+        c.nodes[ c.count++ ] = node;
+      }
+      if( !c.count )
+        return nullptr;
+    }
+    return c.nodes[ --c.count ] + 1;
+  }
+
+  inline std::size_t capacity( ) const { return count_; }
+
+private:
+  typedef details::NodeHeader node_type;
+
+  struct Cache
+  {
+    McmrBufferPool*   pool  = nullptr;
+    unsigned          count = 0;
+    node_type*        nodes[ CacheSize ];
+
+    ~Cache( ) { flush( ); }
+
+    void flush( )
+    {
+      if( count ) {
+        pool->push_shared( nodes, count );
+        count = 0;
+      }
+    }
+  };
+
+  static Cache& cache( )
+  {
+    static thread_local Cache c;
+    return c;
+  }
+
+  // the head keeps the node number ( index + 1, 0 for none ) in the low half
+  static const uint64_t INDEX_MASK = 0xFFFFFFFFull;
+
+  static inline uint64_t make_head( uint64_t number, uint64_t tag )
+  {
+    return ( tag << 32 ) | number;
+  }
+
+  inline node_type* node_at( uint64_t number ) const
+  {
+    return number ? reinterpret_cast< node_type* >( slab_ + ( number - 1 ) * stride_ ) : nullptr;
+  }
+
+  inline uint64_t number_of( node_type* node ) const
+  {
+    return node ? ( reinterpret_cast< char* >( node ) - slab_ ) / stride_ + 1 : 0;
+  }
+
+  // pushes 'count' nodes with one CAS
+  void push_shared( node_type** nodes, unsigned count )
+  {
+    assert( count );
+
+    for( unsigned i( 1 ); i < count; ++i )
+      nodes[ i - 1 ]->next.store( nodes[ i ], std::memory_order_relaxed );
+
+    node_type*     last  = nodes[ count - 1 ];
+    const uint64_t first = number_of( nodes[ 0 ] );
+    uint64_t head = head_.load( std::memory_order_relaxed );
+    do {
+      last->next.store( node_at( head & INDEX_MASK ), std::memory_order_relaxed );
+    } while( !head_.compare_exchange_weak( head, make_head( first, ( head >> 32 ) + 1 ),
+                                           std::memory_order_release, std::memory_order_relaxed ) );
+  }
+
+  node_type* pop_shared( )
+  {
+    uint64_t head = head_.load( std::memory_order_acquire );
+    while( node_type* node = node_at( head & INDEX_MASK ) ) {
+      const uint64_t next = number_of( node->next.load( std::memory_order_relaxed ) );
+      if( head_.compare_exchange_weak( head, make_head( next, ( head >> 32 ) + 1 ),
+                                       std::memory_order_acquire, std::memory_order_acquire ) )
+        return node;
+    }
+    return nullptr;
+  }
+
+private:
+  char*                                 slab_   = nullptr;
+  std::size_t                           stride_ = 0;
+  std::size_t                           count_  = 0;
+  ALIGNAS( 64 ) std::atomic< uint64_t > head_{ 0 };  // of the shared list
+}; // class McmrBufferPool
+
+//--------------------------------------------------------------------------------
+} // namespace concpool
+//--------------------------------------------------------------------------------
+# endif // _MCMR_BUFFER_POOL_H_
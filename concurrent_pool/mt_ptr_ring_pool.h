@@ -2,12 +2,32 @@
 # define _MT_PTR_RING_POOL_H_
 //--------------------------------------------------------------------------------
 # include <cassert>
+# include <cstdint>
 # include <memory>
-# include <mutex>
 # include <atomic>
+# include <type_traits>
+//--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
+# include <utils/spin_lock.h>
 //--------------------------------------------------------------------------------
 namespace concpool {
 //--------------------------------------------------------------------------------
+//
+// Any number of threads take and release pointers. Every slot carries a
+// sequence number: 'pos' when it waits for the release number 'pos' and
+// 'pos + 1' when it holds the pointer for the take number 'pos'. A taker claims
+// its number with a CAS on 'tail_' and hands the slot over to the release a lap
+// later.
+//
+// A releaser claims its number with a CAS on 'head_' too, once the slot is
+// handed over. So neither side is lock-free: a taker of the previous lap which
+// has claimed the slot and is preempted before handing it over stalls the
+// releasers (they spin, then yield) until it goes on. Takers never wait.
+//
+// The pool holds at most its size of pointers. A release beyond that is refused
+// and counted in 'over_releases( )', the pointer stays with the caller.
+//
+//--------------------------------------------------------------------------------
 
 template < typename Type >
 class PtrRingPool
@@ -15,68 +35,111 @@ class PtrRingPool
 public:
   typedef Type                                                  element_type;
   typedef typename std::remove_extent< element_type >::type*    pointer_type;
-  
+
   PtrRingPool( const PtrRingPool& )               = delete;
   PtrRingPool& operator =( const PtrRingPool& )   = delete;
   PtrRingPool( )                                  = default;
-  
+
 public:
   ~PtrRingPool( )
   {
     std::default_delete< element_type > deleter;
-    for( unsigned i( 0 ); i < size_; ++i )
-      deleter( ring_[ i ] );
+    const uint64_t head = head_.load( std::memory_order_relaxed );
+    for( uint64_t i( tail_.load( std::memory_order_relaxed ) ); i < head; ++i )
+      deleter( at( i ).ptr );
+    delete[ ] ring_;
   }
-  
+
   void alloc( unsigned size )
   {
-    assert( ring_ == nullptr );
-    
-    ring_ = new pointer_type[ size ];
+    assert( ring_ == nullptr && size );
+
+    ring_ = new Slot[ size ];
     for( unsigned i( 0 ); i < size; ++i )
-      ring_[ i ] = nullptr;
+      ring_[ i ].seq.store( i, std::memory_order_relaxed );
     size_ = size;
-    tail_ = 0;
-    head_ = 0;
+    tail_.store( 0, std::memory_order_relaxed );
+    head_.store( 0, std::memory_order_release );
   }
-  
+
   inline pointer_type take( )
   {
-    pointer_type val = nullptr;
-    {
-      lock_type lk( mtx_ );
-      std::swap( val, at( tail_ ) );
-      if( val ) ++tail_;
+    uint64_t pos = tail_.load( std::memory_order_relaxed );
+    for( ; ; ) {
+      Slot& slot = at( pos );
+      const int64_t diff = static_cast< int64_t >( slot.seq.load( std::memory_order_acquire ) - ( pos + 1 ) );
+      if( diff == 0 ) {
+        if( tail_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+          pointer_type val = slot.ptr;
+          slot.seq.store( pos + size_, std::memory_order_release );
+          return val;
+        }
+      } else if( diff < 0 ) {
+        return nullptr; // empty, or the release of 'pos' is in progress
+      } else {
+        pos = tail_.load( std::memory_order_relaxed );
+      }
+    }
+  }
+
+  // false when the pool is full already
+  inline bool release( pointer_type ptr )
+  {
+    concur::utils::Backoff< 64 > backoff;
+    uint64_t pos = head_.load( std::memory_order_relaxed );
+    for( ; ; ) {
+      Slot& slot = at( pos );
+      const int64_t diff = static_cast< int64_t >( slot.seq.load( std::memory_order_acquire ) - pos );
+      if( diff == 0 ) {
+        if( head_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+          slot.ptr = ptr;
+          slot.seq.store( pos + 1, std::memory_order_release );
+          return true;
+        }
+      } else if( diff < 0 ) {
+        // the take of the previous lap is in progress or not even claimed; the
+        // RMW reads the latest 'tail_' for sure
+        const uint64_t tail = tail_.fetch_add( 0, std::memory_order_relaxed );
+        if( static_cast< int64_t >( pos - tail ) >= static_cast< int64_t >( size_ ) ) {
+          over_releases_.fetch_add( 1, std::memory_order_relaxed );
+          return false;
+        }
+        backoff( );
+        pos = head_.load( std::memory_order_relaxed );
+      } else {
+        pos = head_.load( std::memory_order_relaxed );
+      }
     }
-    return val;
   }
-  
-  inline void release( pointer_type ptr )
+
+  // refused releases, a bug of the caller
+  inline uint64_t over_releases( ) const
   {
-    lock_type lk( mtx_ );
-    at( head_++ ) = ptr;
+    return over_releases_.load( std::memory_order_relaxed );
   }
-  
+
 private:
-  typedef std::atomic< pointer_type >     atomic_pointer_type;
-  typedef std::mutex                      mutex_type;
-  typedef std::lock_guard< mutex_type >   lock_type;
-  
-  inline pointer_type& at( unsigned i )
+  struct Slot
+  {
+    std::atomic< uint64_t >   seq;
+    pointer_type              ptr = nullptr;
+  };
+
+  inline Slot& at( uint64_t i )
   {
     return ring_[ i % size_ ];
   }
-  
+
 private:
-  std::mutex            mtx_;
-  atomic_pointer_type*  ring_ = nullptr;
-  unsigned              size_ = 0;
-  unsigned              head_ = 0;
-  unsigned              tail_ = 0;
+  Slot*                                 ring_ = nullptr;
+  unsigned                              size_ = 0;
+  ALIGNAS( 64 ) std::atomic< uint64_t > tail_{ 0 }; // take from
+  ALIGNAS( 64 ) std::atomic< uint64_t > head_{ 0 }; // release to
+  std::atomic< uint64_t >               over_releases_{ 0 };
 }; // class PtrRingPool
 
 //--------------------------------------------------------------------------------
-} // namespace concur
+} // namespace concpool
 //--------------------------------------------------------------------------------
 
 # endif // _MT_PTR_RING_POOL_H_
@@ -15,6 +15,8 @@ public:
   typedef typename pool_type::element_type  element_type;
   typedef typename pool_type::node_type     node_type;
   
+  friend pool_type;
+  
 public:
   Holder( ) : pool_( nullptr ), node_( nullptr ) { }
   Holder( pool_type* pool, node_type* node ) : pool_( pool ), node_( node ) { }
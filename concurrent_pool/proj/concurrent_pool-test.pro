@@ -32,7 +32,9 @@ SOURCES += \
     ../test/src/test_mt_scmr_ring_pool.cpp \
     ../test/src/test_mt_scsr_pool.cpp \
     ../test/src/test_mt_scmr_octopus_pool.cpp \
-    ../test/src/test_mt_ptr_ring_pool.cpp
+    ../test/src/test_mt_ptr_ring_pool.cpp \
+    ../test/src/test_scmr_sized_buffer_pool.cpp \
+    ../test/src/test_mt_mcmr_buffer_pool.cpp
 
 HEADERS += \
     ../test/src/config.h \
@@ -3,6 +3,10 @@ HEADERS += \
     $$PWD/../pool_holder.h \
     $$PWD/../scmr_pool.h \
     $$PWD/../scmr_buffer_pool.h \
+    $$PWD/../scmr_sized_buffer_pool.h \
+    $$PWD/../mcmr_buffer_pool.h \
     $$PWD/../scmr_ring_pool.h \
+    $$PWD/../scmr_elastic_ring_pool.h \
     $$PWD/../scsr_pool.h \
-    $$PWD/../scmr_octopus_pool.h
+    $$PWD/../scmr_octopus_pool.h \
+    $$PWD/../mt_ptr_ring_pool.h
@@ -1,9 +1,14 @@
 # ifndef _SCMR_BUFFER_POOL_H_
 # define _SCMR_BUFFER_POOL_H_
 //--------------------------------------------------------------------------------
+# include <cassert>
+# include <cstddef>
 # include <atomic>
+# include <new>
 # include <stdexcept>
 //--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
+//--------------------------------------------------------------------------------
 namespace concpool {
 //--------------------------------------------------------------------------------
 namespace details {
@@ -17,64 +22,91 @@ struct NodeHeader
   NodeHeader( void* pool_ptr ) : pool( pool_ptr ), next( nullptr ) { }
 };
 
-NodeHeader* create_node( void* pool_ptr, std::size_t payload_size )
-{
-  void* mem = std::malloc( sizeof( NodeHeader ) + payload_size );
-  if( !mem )
-    throw std::bad_alloc( );
-  return new( mem ) NodeHeader( pool_ptr );
-}
-
-void free_node_chain( NodeHeader* begin )
-{
-  while( begin ) {
-    NodeHeader* next = begin->next.load( std::memory_order_relaxed );
-    std::free( begin );
-    begin = next;
-  }
-}
-
 //--------------------------------------------------------------------------------
 } // namespace details
 //--------------------------------------------------------------------------------
 
-class ScmrBufferPool
+// The list of free buffers and the releasing side, which doesn't depend on how
+// the buffers are stored: any buffer goes back with 'ScmrBufferPool< >::release'.
+class ScmrBufferList
 {
 public:
-  ScmrBufferPool( const ScmrBufferPool& )             = delete;
-  ScmrBufferPool& operator =( const ScmrBufferPool& ) = delete;
+  ScmrBufferList( const ScmrBufferList& )             = delete;
+  ScmrBufferList& operator =( const ScmrBufferList& ) = delete;
   
   static void release( void* ptr )
   {
     assert( ptr );
     
     details::NodeHeader* hdr = static_cast< details::NodeHeader* >( ptr ) - 1;
-    static_cast< ScmrBufferPool* >( hdr->pool )->push_node( hdr );
+    static_cast< ScmrBufferList* >( hdr->pool )->push_node( hdr );
   }
   
-public:
-  ScmrBufferPool( ) : tail_( nullptr ), head_( nullptr ) { }
-  ~ScmrBufferPool( ) { details::free_node_chain( tail_ ); }
+  // Links 'next' after 'ptr' for 'release_chain', both buffers of the same
+  // pool and out of it.
+  static inline void link( void* ptr, void* next )
+  {
+    assert( to_node( ptr )->pool == to_node( next )->pool );
+    to_node( ptr )->next.store( to_node( next ), std::memory_order_relaxed );
+  }
   
-  void init( std::size_t count, std::size_t payload_size )
+  // Returns the buffers linked from 'first' to 'last' with one exchange.
+  static void release_chain( void* first, void* last )
   {
-    if( tail_ || head_.load( ) )
-      throw std::logic_error( "pool already initialized" );
+    assert( first && last );
     
-    head_.store( tail_ = details::create_node( this, payload_size ) );
-    while( count-- )
-      push_node( details::create_node( this, payload_size ) );
+    node_type* last_node = to_node( last );
+    static_cast< ScmrBufferList* >( last_node->pool )->push_chain( to_node( first ), last_node );
   }
   
+  // Returns the buffers of [begin, end), every run of buffers of the same pool
+  // with one exchange.
+  template < typename InputIt >
+  static void release_all( InputIt begin, InputIt end )
+  {
+    if( begin == end )
+      return;
+    
+    node_type* first = to_node( *begin );
+    node_type* last  = first;
+    for( ++begin; begin != end; ++begin ) {
+      node_type* node = to_node( *begin );
+      if( node->pool != last->pool ) {
+        static_cast< ScmrBufferList* >( last->pool )->push_chain( first, last );
+        first = node;
+      } else {
+        last->next.store( node, std::memory_order_relaxed );
+      }
+      last = node;
+    }
+    static_cast< ScmrBufferList* >( last->pool )->push_chain( first, last );
+  }
+  
+public:
   inline void* pop( )
   {
     node_type* node = pop_node( );
     return node ? ( node + 1 ) : nullptr;
   }
 
-private:
+protected:
   typedef details::NodeHeader node_type;
   
+  ScmrBufferList( ) : tail_( nullptr ), head_( nullptr ) { }
+  
+  // links the nodes carved out of 'slab', the first one becomes the dummy
+  void init_list( char* slab, std::size_t count, std::size_t stride )
+  {
+    head_.store( tail_ = new( slab ) node_type( this ) );
+    while( count-- )
+      push_node( new( slab += stride ) node_type( this ) );
+  }
+  
+  static inline node_type* to_node( void* ptr )
+  {
+    return static_cast< node_type* >( ptr ) - 1;
+  }
+  
   void push_node( node_type* node ) 
   {
     assert( node && ( node->pool == this ) && ( node->next.load( ) == nullptr ) );
@@ -82,6 +114,16 @@ private:
     node_type* old_head = head_.exchange( node, std::memory_order_acq_rel );
     old_head->next.store( node, std::memory_order_release );
   }
+  
+  // 'first' .. 'last' are linked already
+  void push_chain( node_type* first, node_type* last )
+  {
+    assert( first->pool == this && last->pool == this );
+    
+    last->next.store( nullptr, std::memory_order_relaxed );
+    node_type* old_head = head_.exchange( last, std::memory_order_acq_rel );
+    old_head->next.store( first, std::memory_order_release );
+  }
 
   node_type* pop_node( ) 
   {
@@ -94,6 +136,48 @@ private:
 private:
   node_type*                 tail_; // pop elements from
   std::atomic< node_type* >  head_; // release elements to
+}; // class ScmrBufferList
+
+//--------------------------------------------------------------------------------
+//
+// All the buffers are carved out of one slab taken from 'StoragePolicy', so
+// 'concur::utils::mapped_storage' puts them on huge pages of a chosen NUMA node.
+// The destructor frees the slab, buffers still out of the pool included.
+//
+//--------------------------------------------------------------------------------
+
+template < typename StoragePolicy = concur::utils::heap_storage >
+class ScmrBufferPool : public ScmrBufferList
+{
+public:
+  typedef StoragePolicy storage_policy;
+  
+  ScmrBufferPool( ) = default;
+  ~ScmrBufferPool( ) { storage_.deallocate( slab_, slab_size_ ); }
+  
+  void init( std::size_t count, std::size_t payload_size )
+  {
+    if( slab_ )
+      throw std::logic_error( "pool already initialized" );
+    
+    // payloads keep the alignment 'malloc' would give them
+    const std::size_t align   = ALIGNOF( std::max_align_t );
+    const std::size_t stride  = ( sizeof( node_type ) + payload_size + align - 1 ) / align * align;
+    
+    slab_ = storage_.allocate( 64, stride * ( count + 1 ) );
+    if( !slab_ )
+      throw std::bad_alloc( );
+    slab_size_ = stride * ( count + 1 );
+    
+    init_list( static_cast< char* >( slab_ ), count, stride );
+  }
+  
+  inline const storage_policy& storage( ) const { return storage_; }
+  
+private:
+  void*           slab_       = nullptr;
+  std::size_t     slab_size_  = 0;
+  storage_policy  storage_;
 }; // class ScmrBufferPool
 
 //--------------------------------------------------------------------------------
@@ -0,0 +1,285 @@
+# ifndef _SCMR_ELASTIC_RING_POOL_H_
+# define _SCMR_ELASTIC_RING_POOL_H_
+//--------------------------------------------------------------------------------
+# include <cstddef>
+# include <cstdlib>
+# include <atomic>
+# include <functional>
+# include <memory>
+# include <new>
+# include <stdexcept>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
+//--------------------------------------------------------------------------------
+namespace concpool {
+//--------------------------------------------------------------------------------
+//
+// Elastic ScmrRingPool: the pool is a list of ring segments, every segment owns
+// its elements and a ring of the same size, so a release never needs more than
+// the ring of the element's own segment. Every element is prefixed with a header
+// pointing to its segment.
+//
+// Only the consumer grows or shrinks the pool:
+// - after 'grow_after' failed pops in a row it appends a segment of
+//   'segment_size' elements (up to 'max_capacity');
+// - when idle elements stay at or above 'high_watermark' for a whole
+//   'shrink_period' of pops and nothing was popped from the last segment
+//   meanwhile, it frees the last segment if all its elements are back and at
+//   least 'low_watermark' idle elements remain after that.
+// The consumer prefers lower segments, so the last one tends to become idle.
+// Releasers never wait for the consumer: they touch only the element's segment,
+// which can't be freed while any of its elements is out.
+//
+//--------------------------------------------------------------------------------
+
+template < typename Type, std::size_t Alignment = 64,
+           typename IndexPolicy = concur::utils::modulo_index >
+class ScmrElasticRingPool
+{
+public:
+  typedef Type element_type;
+
+  struct config_type
+  {
+    std::size_t   segment_size    = 1024;   // elements in a grown segment
+    unsigned      grow_after      = 16;     // failed pops in a row before growing
+    std::size_t   max_capacity    = 0;      // 0 - unlimited
+    std::size_t   high_watermark  = 0;      // 0 - never shrink
+    std::size_t   low_watermark   = 0;
+    unsigned      shrink_period   = 4096;   // pops between idle element checks
+  };
+
+  ScmrElasticRingPool( const ScmrElasticRingPool& )             = delete;
+  ScmrElasticRingPool& operator =( const ScmrElasticRingPool& ) = delete;
+
+public:
+  ScmrElasticRingPool( ) = default;
+
+  inline void configure( const config_type& cfg ) { cfg_ = cfg; }
+
+  template < typename ...Args >
+  void init( unsigned count, std::size_t element_size, Args ...args )
+  {
+    if( !segments_.empty( ) )
+      throw std::logic_error( "pool already initialized" );
+
+    stride_     = HEADER_SIZE + round_up( element_size );
+    construct_  = [ args... ]( void* ptr ) { new( ptr ) Type( args... ); };
+    add_segment( count );
+  }
+
+  static inline void release( element_type* ptr )
+  {
+    header_of( ptr )->segment->release( ptr );
+  }
+
+  Type* pop( )
+  {
+    const std::size_t count = segments_.size( );
+    for( std::size_t i( 0 ); i < count; ++i ) {
+      if( Type* ptr = segments_[ i ]->pop( ) ) {
+        failed_ = 0;
+        last_used_ |= ( i && i + 1 == count );
+        if( ++pops_ >= cfg_.shrink_period )
+          check_idle( );
+        return ptr;
+      }
+    }
+
+    if( ++failed_ >= cfg_.grow_after && can_grow( ) ) {
+      failed_ = 0;
+      add_segment( cfg_.segment_size );
+      grows_.fetch_add( 1, std::memory_order_relaxed );
+      return segments_.back( )->pop( );
+    }
+    return nullptr;
+  }
+
+  // statistics, may be read by any thread
+  inline std::size_t  capacity( ) const { return capacity_.load( std::memory_order_relaxed ); }
+  inline uint64_t     grows( )    const { return grows_.load( std::memory_order_relaxed ); }
+  inline uint64_t     shrinks( )  const { return shrinks_.load( std::memory_order_relaxed ); }
+
+private:
+  struct ALIGNAS( Alignment ) Node
+  {
+    Node( const Node& )             = delete;
+    Node& operator =( const Node& ) = delete;
+
+    Node( ) : ptr( nullptr ) { }
+
+    std::atomic< Type* > ptr;
+  };
+
+  typedef uint_fast32_t                                                size_type;
+  typedef concur::utils::aligned_ring< Node, size_type, IndexPolicy >  ring_type;
+
+  class Segment;
+
+  struct Header
+  {
+    Segment* segment;
+  };
+
+  static const std::size_t HEADER_SIZE = ALIGNOF( std::max_align_t );
+  static_assert( sizeof( Header ) <= HEADER_SIZE, "header doesn't fit" );
+
+  static inline std::size_t round_up( std::size_t size )
+  {
+    return ( size + HEADER_SIZE - 1 ) / HEADER_SIZE * HEADER_SIZE;
+  }
+
+  static inline Header* header_of( element_type* ptr )
+  {
+    return reinterpret_cast< Header* >( reinterpret_cast< char* >( ptr ) - HEADER_SIZE );
+  }
+
+  // The same release/pop protocol as ScmrRingPool over the segment's elements,
+  // all of them allocated as one block.
+  class Segment
+  {
+  public:
+    Segment( std::size_t count, std::size_t stride, const std::function< void( void* ) >& construct )
+      : block_( static_cast< char* >( std::malloc( count * stride ) ) ), stride_( stride )
+    {
+      if( !block_ )
+        throw std::bad_alloc( );
+
+      ring_.init( static_cast< size_type >( count ) );
+      for( size_type i( 0 ); i < count; ++i ) {
+        char* mem = block_ + i * stride_;
+        new( mem ) Header{ this };
+        construct( mem + HEADER_SIZE );
+        ring_.at( i ).ptr.store( reinterpret_cast< Type* >( mem + HEADER_SIZE ), std::memory_order_relaxed );
+      }
+    }
+
+    ~Segment( )
+    {
+      for( size_type i( 0 ); i < ring_.size( ); ++i )
+        reinterpret_cast< Type* >( block_ + i * stride_ + HEADER_SIZE )->~Type( );
+      std::free( block_ );
+    }
+
+    // 'rnum_' is padded to a cache line, which plain 'new' ignores before C++17
+    static void* operator new( std::size_t size )
+    {
+      void* ptr = aligned_malloc( ALIGNOF( Segment ), size );
+      if( !ptr )
+        throw std::bad_alloc( );
+      return ptr;
+    }
+
+    static void operator delete( void* ptr ) { aligned_free( ptr ); }
+
+    inline void release( Type* ptr )
+    {
+      Node& node = ring_.at( rnum_.fetch_add( 1, std::memory_order_relaxed ) );
+      node.ptr.store( ptr, std::memory_order_release );
+    }
+
+    inline Type* pop( )
+    {
+      // only the consumer empties slots, so no exchange is needed
+      std::atomic< Type* >& slot = ring_.at( cnum_ ).ptr;
+      Type* ptr = slot.load( std::memory_order_acquire );
+      if( ptr ) {
+        slot.store( nullptr, std::memory_order_relaxed );
+        ++cnum_;
+      }
+      return ptr;
+    }
+
+    inline std::size_t size( ) const { return ring_.size( ); }
+
+    // elements in the ring; a release in progress is counted already
+    inline std::size_t idle( ) const
+    {
+      return ring_.size( ) - static_cast< size_type >( cnum_ - rnum_.load( std::memory_order_relaxed ) );
+    }
+
+    // true if every element is back, so no releaser can touch the segment
+    bool all_back( )
+    {
+      for( size_type i( 0 ); i < ring_.size( ); ++i ) {
+        if( !ring_.at( i ).ptr.load( std::memory_order_acquire ) )
+          return false;
+      }
+      return true;
+    }
+
+  private:
+    ring_type                         ring_;
+    char*                             block_;
+    std::size_t                       stride_;
+    size_type                         cnum_ = 0; // consume number
+    ALIGNAS( 64 ) std::atomic< size_type > rnum_{ 0 }; // release number
+  }; // class Segment
+
+  inline bool can_grow( ) const
+  {
+    return cfg_.segment_size
+        && ( !cfg_.max_capacity || capacity( ) + cfg_.segment_size <= cfg_.max_capacity );
+  }
+
+  void add_segment( std::size_t count )
+  {
+    segments_.emplace_back( new Segment( count, stride_, construct_ ) );
+    capacity_.store( capacity( ) + count, std::memory_order_relaxed );
+  }
+
+  // the idle level must hold at two checks in a row and the last segment must
+  // not be popped from in between to shrink
+  void check_idle( )
+  {
+    pops_ = 0;
+    if( !cfg_.high_watermark || segments_.size( ) < 2 )
+      return;
+
+    if( last_used_ ) {
+      last_used_ = false;
+      idle_checks_ = 0;
+      return;
+    }
+
+    std::size_t idle = 0;
+    for( const auto& segment : segments_ )
+      idle += segment->idle( );
+
+    if( idle < cfg_.high_watermark ) {
+      idle_checks_ = 0;
+      return;
+    }
+    if( ++idle_checks_ < 2 )
+      return;
+
+    Segment& last = *segments_.back( );
+    if( idle - last.size( ) >= cfg_.low_watermark && last.all_back( ) ) {
+      capacity_.store( capacity( ) - last.size( ), std::memory_order_relaxed );
+      segments_.pop_back( );
+      shrinks_.fetch_add( 1, std::memory_order_relaxed );
+      idle_checks_ = 0;
+    }
+  }
+
+private:
+  typedef std::unique_ptr< Segment > segment_ptr;
+
+  config_type                         cfg_;
+  std::vector< segment_ptr >          segments_;    // used only by the consumer
+  std::function< void( void* ) >      construct_;
+  std::size_t                         stride_       = 0;
+  unsigned                            failed_       = 0;
+  unsigned                            pops_         = 0;
+  unsigned                            idle_checks_  = 0;
+  bool                                last_used_    = false;
+  std::atomic< std::size_t >          capacity_{ 0 };
+  std::atomic< uint64_t >             grows_{ 0 };
+  std::atomic< uint64_t >             shrinks_{ 0 };
+}; // class ScmrElasticRingPool
+
+//--------------------------------------------------------------------------------
+} // namespace concpool
+//--------------------------------------------------------------------------------
+# endif // _SCMR_ELASTIC_RING_POOL_H_
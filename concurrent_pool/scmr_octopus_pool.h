@@ -6,12 +6,26 @@
 # include <utility>
 # include <memory>
 //--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
 # include "scsr_pool.h"
 //--------------------------------------------------------------------------------
 namespace concpool {
 //--------------------------------------------------------------------------------
+//
+// Every releaser has its own lane (ScsrPool), the consumer pops from them in
+// turn. Releasers raise a per-lane hint after each release and the consumer
+// probes only lanes with the hint raised, so empty lanes cost a single load.
+//
+// The consumer drops a hint when the lane turns out to be empty and then probes
+// the lane once more: a releaser which has raised the hint before the drop has
+// its element seen by that probe, a later one raises the hint again.
+//
+// The lanes take their slabs from 'StoragePolicy'.
+//
+//--------------------------------------------------------------------------------
 
-template < typename Type, unsigned Alignment = 64 >
+template < typename Type, unsigned Alignment = 64,
+           typename StoragePolicy = concur::utils::heap_storage >
 class ScmrOctopusPool
 {
 public:
@@ -21,18 +35,20 @@ public:
   ScmrOctopusPool& operator =( const ScmrOctopusPool& ) = delete;
   
 public:
-  ScmrOctopusPool( ) : pools_( nullptr ) { }
+  ScmrOctopusPool( ) = default;
   
   template < typename ...Args >
   void init( unsigned rcount, std::size_t count, std::size_t element_size, Args ...args )
   {
     assert( !pools_ && "pool already initialized" );
     
-    pools_.reset( new pool_type[ rcount ] );
+    pools_ = concur::utils::make_aligned_array< pool_type >( rcount );
+    hints_ = concur::utils::make_aligned_array< Hint >( rcount );
     for( unsigned i( 0 ); i < rcount; ++i ) {
       pool_type&  pool     = pools_[ i ];
       std::size_t elements = count / ( rcount - i );
       pool.init( elements, element_size, args... );
+      hints_[ i ].ready.store( elements > 1, std::memory_order_relaxed ); // one node stays in a lane
       count -= elements;
     }
     
@@ -44,23 +60,72 @@ public:
   {
     const unsigned end = cnum_ + rcount_;
     do {
-      if( element_type* element = pools_[ cnum_++ % rcount_ ].pop( ) )
+      const unsigned lane = cnum_++ % rcount_;
+      if( element_type* element = pop_lane( lane ) )
         return element;
     } while( cnum_ != end );
     return nullptr;
   }
   
+  // Pops up to 'max' elements from the first lane that has any.
+  template < typename OutputIt >
+  unsigned pop_n( OutputIt dst, unsigned max )
+  {
+    const unsigned end = cnum_ + rcount_;
+    do {
+      const unsigned lane = cnum_++ % rcount_;
+      unsigned count = 0;
+      while( count < max ) {
+        element_type* element = pop_lane( lane );
+        if( !element )
+          break;
+        *dst++ = element;
+        ++count;
+      }
+      if( count )
+        return count;
+    } while( cnum_ != end );
+    return 0;
+  }
+  
   inline void release( unsigned rnum, element_type* ptr )
   {
     pools_[ rnum ].release( ptr );
+    hints_[ rnum ].ready.store( true, std::memory_order_release );
   }
 
 private:
-  typedef ScsrPool< element_type, Alignment > pool_type;
+  typedef ScsrPool< element_type, Alignment, StoragePolicy > pool_type;
+  
+  struct ALIGNAS( 64 ) Hint
+  {
+    std::atomic< bool > ready;
+    
+    Hint( ) : ready( false ) { }
+  };
+  
+  element_type* pop_lane( unsigned lane )
+  {
+    std::atomic< bool >& ready = hints_[ lane ].ready;
+    if( !ready.load( std::memory_order_relaxed ) )
+      return nullptr;
+    
+    pool_type& pool = pools_[ lane ];
+    if( element_type* element = pool.pop( ) )
+      return element;
+    
+    // synchronized with the last raise, so the probe below sees its element
+    ready.exchange( false, std::memory_order_acq_rel );
+    element_type* element = pool.pop( );
+    if( element )
+      ready.store( true, std::memory_order_relaxed );
+    return element;
+  }
   
-  std::unique_ptr< pool_type[ ] >   pools_;
-  unsigned                          rcount_ = 0;
-  unsigned                          cnum_   = 0;
+  concur::utils::aligned_array< pool_type >  pools_;
+  concur::utils::aligned_array< Hint >       hints_;
+  unsigned                                   rcount_ = 0;
+  unsigned                                   cnum_   = 0;
 }; // class ScmrPool
 
 
@@ -2,16 +2,35 @@
 # define _SCMR_POOL_H_
 //--------------------------------------------------------------------------------
 # include <cassert>
+# include <cstdint>
 # include <atomic>
 # include <utility>
 //--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
+//--------------------------------------------------------------------------------
 # include "pool_node.h"
 # include "pool_holder.h"
 //--------------------------------------------------------------------------------
 namespace concpool {
 //--------------------------------------------------------------------------------
+//
+// With 'MagazineSize' > 0 a releasing thread doesn't push every node: it
+// collects them in a thread-local magazine and pushes the whole chain with a
+// single exchange on 'head_' once the magazine is full, when it releases to
+// another pool of the same type, on 'flush( )' and on thread exit.
+//
+// Nodes in magazines are invisible to the consumer, so the pool must have more
+// than 'releasers * ( MagazineSize - 1 )' elements to never run dry for good,
+// and every releasing thread must flush or exit before the pool is destroyed
+// (the destroying thread's magazine is flushed by the destructor).
+//
+// With 'CountStats' the pool counts released nodes and the exchanges they took.
+// The counters are shared by all releasers, so they are on by default only with
+// a magazine, where they are touched once per chain, not once per release.
+//
+//--------------------------------------------------------------------------------
 
-template < typename T >
+template < typename T, unsigned MagazineSize = 0, bool CountStats = ( MagazineSize > 0 ) >
 class ScmrPool // Single consumer - multiple releasers
 {
 public:
@@ -31,6 +50,12 @@ public:
 
   ~ScmrPool( )
   {
+    if( MagazineSize ) {
+      Magazine& mag = magazine( );
+      if( mag.pool == this )
+        mag.flush( );
+    }
+    
     while( node_type* n = pop_node( ) )
       delete n;
     delete tail_;
@@ -39,8 +64,10 @@ public:
   template < typename ...Args >
   void init( std::size_t count, Args ...args )
   {
-    while( count-- )
-      push_node( new node_type( args... ) );
+    while( count-- ) {
+      node_type* node = new node_type( args... );
+      push_chain( node, node );
+    }
   }
   
   template < typename ...Args >
@@ -53,13 +80,121 @@ public:
   {
     return holder_type( this, pop_node( ) );
   }
+  
+  // Releases the elements of all non-empty holders in [begin, end) with one
+  // exchange, the holders become empty. All of them must belong to this pool.
+  template < typename InputIt >
+  void release_all( InputIt begin, InputIt end )
+  {
+    node_type*  first = nullptr;
+    node_type*  last  = nullptr;
+    unsigned    count = 0;
+    for( ; begin != end; ++begin ) {
+      holder_type& holder = *begin;
+      if( !holder )
+        continue;
+      assert( holder.pool_ == this );
+      
+      node_type* node = holder.node_;
+      holder.node_ = nullptr;
+      if( last )
+        last->next.store( node, std::memory_order_relaxed );
+      else
+        first = node;
+      last = node;
+      ++count;
+    }
+    
+    if( count ) {
+      push_chain( first, last );
+      count_push( count );
+    }
+  }
+  
+  // pushes the calling thread's magazine to its pool
+  static void flush( )
+  {
+    if( MagazineSize )
+      magazine( ).flush( );
+  }
+  
+  // with 'CountStats', released nodes and exchanges on 'head_' they took (one
+  // per node without a magazine); zeros otherwise
+  inline uint64_t releases( ) const   { return stats_.releases.load( std::memory_order_relaxed ); }
+  inline uint64_t exchanges( ) const  { return stats_.exchanges.load( std::memory_order_relaxed ); }
 
 private:
-  void push_node( node_type* node ) 
+  struct Magazine
+  {
+    ScmrPool*     pool  = nullptr;
+    node_type*    first = nullptr;
+    node_type*    last  = nullptr;
+    unsigned      count = 0;
+    
+    ~Magazine( ) { flush( ); }
+    
+    void flush( )
+    {
+      if( count ) {
+        pool->push_chain( first, last );
+        pool->count_push( count );
+        first = last = nullptr;
+        count = 0;
+      }
+    }
+  };
+  
+  struct ALIGNAS( 64 ) Stats
+  {
+    std::atomic< uint64_t > releases{ 0 };
+    std::atomic< uint64_t > exchanges{ 0 };
+  };
+  
+  inline void count_push( unsigned count )
+  {
+    if( !CountStats )
+      return;
+    stats_.releases.fetch_add( count, std::memory_order_relaxed );
+    stats_.exchanges.fetch_add( 1, std::memory_order_relaxed );
+  }
+  
+  static Magazine& magazine( )
+  {
+    static thread_local Magazine mag;
+    return mag;
+  }
+  
+  void push_node( node_type* node )
   {
     assert( node->next.load( ) == nullptr );
-    node_type* old_head = head_.exchange( node, std::memory_order_acq_rel );
-    old_head->next.store( node, std::memory_order_release );
+    if( !MagazineSize ) {
+      push_chain( node, node );
+      count_push( 1 );
+      return;
+    }
+    
+    Magazine& mag = magazine( );
+    if( mag.pool != this ) {
+      mag.flush( );
+      mag.pool = this;
+    }
+    
+    if( mag.count )
+      mag.last->next.store( node, std::memory_order_relaxed );
+    else
+      mag.first = node;
+    mag.last = node;
+    
+    if( ++mag.count == MagazineSize )
+      mag.flush( );
+  }
+  
+  // 'first' .. 'last' are linked already, 'last->next' is null
+  void push_chain( node_type* first, node_type* last )
+  {
+    assert( last->next.load( ) == nullptr );
+    node_type* old_head = head_.exchange( last, std::memory_order_acq_rel );
+    old_head->next.store( first, std::memory_order_release );
   }
 
   node_type* pop_node( ) 
@@ -75,6 +210,7 @@ private:
 private:
   node_type*                 tail_; // pop elements from (used only by C-thread)
   std::atomic< node_type* >  head_; // release elements to (used only by R-threads)
+  Stats                      stats_;
 }; // class ScmrPool
 
 //--------------------------------------------------------------------------------
@@ -1,7 +1,9 @@
 # ifndef _SCMR_RING_POOL_H_
 # define _SCMR_RING_POOL_H_
 //--------------------------------------------------------------------------------
+# include <cstddef>
 # include <atomic>
+# include <new>
 # include <stdexcept>
 //--------------------------------------------------------------------------------
 # include <utils/mem_utils.h> // from concurrent_queue
@@ -9,7 +11,11 @@
 namespace concpool {
 //--------------------------------------------------------------------------------
 
-template < typename Type, std::size_t Alignment = 64 >
+// Elements live in one slab taken from 'StoragePolicy', the ring of pointers to
+// them is allocated with the same policy.
+template < typename Type, std::size_t Alignment = 64,
+           typename IndexPolicy = concur::utils::modulo_index,
+           typename StoragePolicy = concur::utils::heap_storage >
 class ScmrRingPool
 {
 private:
@@ -23,9 +29,9 @@ private:
     std::atomic< Type* > ptr;
   }; 
   
-  typedef uint_fast32_t                                   size_type;
-  typedef concur::utils::aligned_ring< Node, size_type >  ring_type;
-  typedef std::atomic< size_type >                        atomic_size_type;
+  typedef uint_fast32_t                                                size_type;
+  typedef concur::utils::aligned_ring< Node, size_type, IndexPolicy, StoragePolicy >  ring_type;
+  typedef std::atomic< size_type >                                     atomic_size_type;
 
 public:
   typedef Type element_type;
@@ -40,18 +46,23 @@ public:
     for( size_type i( 0 ); i < ring_.size( ); ++i ) {
       Type* ptr = ring_.at( i ).ptr.load( );
       ptr->~Type( );
-      std::free( ptr );
     }
+    storage_.deallocate( slab_, stride_ * ring_.size( ) );
   }
   
   template < typename ...Args >
   void init( unsigned count, std::size_t element_size, Args ...args )
   {
     ring_.init( count );
+    
+    const std::size_t align = ALIGNOF( std::max_align_t );
+    stride_ = ( element_size + align - 1 ) / align * align;
+    slab_ = static_cast< char* >( storage_.allocate( align, stride_ * count ) );
+    if( !slab_ )
+      throw std::bad_alloc( );
+    
     for( size_type i( 0 ); i < count; ++i ) {
-      void* ptr = static_cast< Type* >( std::malloc( element_size ) );
-      if( !ptr )
-        throw std::bad_alloc( );
+      void* ptr = slab_ + i * stride_;
       ring_.at( i ).ptr.store( new( ptr ) Type( args... ) );
     }
   }
@@ -73,6 +84,9 @@ public:
   
 private:
   ring_type             ring_;
+  StoragePolicy         storage_;   // of the elements slab
+  char*                 slab_   = nullptr;
+  std::size_t           stride_ = 0;
   size_type             cnum_ = 0; // consume number
   atomic_size_type      rnum_ = 0; // release number
 }; // class ScmpRingArray
@@ -0,0 +1,124 @@
+# ifndef _SCMR_SIZED_BUFFER_POOL_H_
+# define _SCMR_SIZED_BUFFER_POOL_H_
+//--------------------------------------------------------------------------------
+# include <cassert>
+# include <cstdint>
+# include <algorithm>
+# include <atomic>
+# include <memory>
+# include <stdexcept>
+# include <vector>
+//--------------------------------------------------------------------------------
+# include <utils/mem_utils.h> // from concurrent_queue
+//--------------------------------------------------------------------------------
+# include "scmr_buffer_pool.h"
+//--------------------------------------------------------------------------------
+namespace concpool {
+//--------------------------------------------------------------------------------
+//
+// Buffers of several size classes, every class is a ScmrBufferPool. 'pop( size )'
+// takes a buffer from the smallest class that fits 'size' and falls through to
+// bigger classes when that one is empty. 'release( ptr )' finds the owning class
+// from the buffer's NodeHeader, so it stays static.
+//
+// Per-class occupancy is the difference of the consumer's pop counter and the
+// releasers' release counter.
+//
+//--------------------------------------------------------------------------------
+
+class ScmrSizedBufferPool
+{
+public:
+  struct class_type
+  {
+    std::size_t   payload_size;
+    std::size_t   count;
+  };
+
+  ScmrSizedBufferPool( const ScmrSizedBufferPool& )             = delete;
+  ScmrSizedBufferPool& operator =( const ScmrSizedBufferPool& ) = delete;
+
+  static void release( void* ptr )
+  {
+    assert( ptr );
+
+    details::NodeHeader* hdr = static_cast< details::NodeHeader* >( ptr ) - 1;
+    SizeClass* cls = static_cast< SizeClass* >( static_cast< ScmrBufferList* >( hdr->pool ) );
+    cls->released.fetch_add( 1, std::memory_order_relaxed );
+    ScmrBufferList::release( ptr );
+  }
+
+public:
+  ScmrSizedBufferPool( ) = default;
+
+  void init( std::vector< class_type > classes )
+  {
+    if( classes_ )
+      throw std::logic_error( "pool already initialized" );
+    if( classes.empty( ) )
+      throw std::invalid_argument( "no size classes" );
+
+    std::sort( classes.begin( ), classes.end( ),
+               []( const class_type& a, const class_type& b ) { return a.payload_size < b.payload_size; } );
+
+    classes_ = concur::utils::make_aligned_array< SizeClass >( classes.size( ) );
+    sizes_.reserve( classes.size( ) );
+    for( std::size_t i( 0 ); i < classes.size( ); ++i ) {
+      classes_[ i ].init( classes[ i ].count, classes[ i ].payload_size );
+      classes_[ i ].capacity = classes[ i ].count;
+      sizes_.push_back( classes[ i ].payload_size );
+    }
+  }
+
+  // power-of-two classes from 'min_size' to 'max_size', 'count' buffers each
+  void init_pow2( std::size_t min_size, std::size_t max_size, std::size_t count )
+  {
+    std::vector< class_type > classes;
+    for( std::size_t size( 1 ); size <= max_size; size <<= 1 ) {
+      if( size >= min_size )
+        classes.push_back( class_type{ size, count } );
+    }
+    init( std::move( classes ) );
+  }
+
+  void* pop( std::size_t size )
+  {
+    std::size_t i = std::lower_bound( sizes_.begin( ), sizes_.end( ), size ) - sizes_.begin( );
+    for( ; i < sizes_.size( ); ++i ) {
+      SizeClass& cls = classes_[ i ];
+      if( void* ptr = cls.pop( ) ) {
+        cls.popped.store( cls.popped.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        return ptr;
+      }
+    }
+    return nullptr;
+  }
+
+  // statistics, may be read by any thread
+  inline std::size_t class_count( ) const                 { return sizes_.size( ); }
+  inline std::size_t payload_size( std::size_t i ) const  { return sizes_[ i ]; }
+  inline std::size_t capacity( std::size_t i ) const      { return classes_[ i ].capacity; }
+
+  // buffers of the class currently out of the pool
+  inline uint64_t in_use( std::size_t i ) const
+  {
+    const SizeClass& cls = classes_[ i ];
+    return cls.popped.load( std::memory_order_relaxed ) - cls.released.load( std::memory_order_relaxed );
+  }
+
+private:
+  struct SizeClass : ScmrBufferPool< >
+  {
+    std::size_t                             capacity = 0;
+    std::atomic< uint64_t >                 popped{ 0 };    // written by the consumer only
+    ALIGNAS( 64 ) std::atomic< uint64_t >   released{ 0 };
+  };
+
+  concur::utils::aligned_array< SizeClass >  classes_;
+  std::vector< std::size_t >                 sizes_;
+}; // class ScmrSizedBufferPool
+
+//--------------------------------------------------------------------------------
+} // namespace concpool
+//--------------------------------------------------------------------------------
+# endif // _SCMR_SIZED_BUFFER_POOL_H_
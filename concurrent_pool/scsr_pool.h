@@ -3,32 +3,65 @@
 //--------------------------------------------------------------------------------
 # include <cassert>
 # include <cstdlib>
+# include <algorithm>
 # include <stdexcept>
 # include <atomic>
+# include <forward_list>
+# include <new>
 # include <utils/mem_utils.h>
 //--------------------------------------------------------------------------------
 namespace concpool {
 //--------------------------------------------------------------------------------
+//
+// Nodes are carved out of slabs of up to SLAB_SIZE bytes, every slab starts
+// with a header linking it to the previous one. The destructor destroys all the
+// elements and frees the slabs, popped-out elements included.
+//
+// Every slab comes from an instance of 'StoragePolicy' of its own, so with
+// 'concur::utils::mapped_storage' each slab is a mapping on huge pages of a
+// chosen NUMA node.
+//
+//--------------------------------------------------------------------------------
 
-template < typename Type, unsigned Alignment = 64 >
+template < typename Type, unsigned Alignment = 64,
+           typename StoragePolicy = concur::utils::heap_storage >
 class ALIGNAS( Alignment ) ScsrPool
 {
 public:
-  typedef Type element_type;
+  typedef Type          element_type;
+  typedef StoragePolicy storage_policy;
   
   ScsrPool( const ScsrPool& )             = delete;
   ScsrPool& operator =( const ScsrPool& ) = delete;
   
 public:
   ScsrPool( ) : tail_( nullptr ), head_( nullptr ) { }
-  ~ScsrPool( ) { destroy_node_chain( tail_ ); }
+  ~ScsrPool( ) { destroy_slabs( ); }
   
   template < typename ...Args >
   void init( std::size_t count, std::size_t element_size, Args ...args )
   {
-    head_ = tail_ = create_node( element_size, args... );
-    while( --count )
-      push_node( create_node( element_size, args... ) );
+    if( tail_ )
+      throw std::logic_error( "pool already initialized" );
+    if( !count )
+      throw std::invalid_argument( "empty pool" );
+    
+    stride_ = ( sizeof( Node ) + element_size + ALIGNOF( Node ) - 1 ) / ALIGNOF( Node ) * ALIGNOF( Node );
+    const std::size_t slab_nodes = ( std::max )( std::size_t( 1 ), ( SLAB_SIZE - sizeof( Slab ) ) / stride_ );
+    
+    while( count ) {
+      Slab* slab = create_slab( ( std::min )( count, slab_nodes ) );
+      count -= slab->capacity;
+      
+      for( char* ptr = slab->begin( ); slab->count < slab->capacity; ptr += stride_ ) {
+        Node* node = create_node( ptr, args... );
+        ++slab->count;
+        if( tail_ )
+          push_node( node );
+        else
+          head_ = tail_ = node;
+      }
+    }
   }
   
   inline element_type* pop( )
@@ -59,26 +92,58 @@ private:
     return reinterpret_cast< Node* >( element ) - 1;
   }
   
-  template < typename ...Args >
-  static Node* create_node( std::size_t element_size, Args ...args )
+  struct ALIGNAS( Alignment ) Slab
+  {
+    Slab*         prev;
+    std::size_t   capacity;   // nodes
+    std::size_t   count;      // constructed nodes
+    
+    inline char* begin( ) { return reinterpret_cast< char* >( this + 1 ); }
+  };
+  
+  // max bytes per slab
+  static const std::size_t SLAB_SIZE = 64 * 1024 * 1024;
+  
+  Slab* create_slab( std::size_t capacity )
   {
-    void* ptr = aligned_malloc( Alignment, sizeof( Node ) + element_size );
-    if( !ptr )
+    storages_.emplace_front( );
+    void* ptr = storages_.front( ).allocate( ALIGNOF( Node ), slab_size( capacity ) );
+    if( !ptr ) {
+      storages_.pop_front( );
       throw std::bad_alloc( );
-    new( ( char* )ptr + sizeof( Node ) ) element_type( args... );
+    }
+    
+    Slab* slab = static_cast< Slab* >( ptr );
+    slab->prev      = slabs_;
+    slab->capacity  = capacity;
+    slab->count     = 0;
+    return slabs_ = slab;
+  }
+  
+  template < typename ...Args >
+  static Node* create_node( void* ptr, Args ...args )
+  {
+    new( static_cast< char* >( ptr ) + sizeof( Node ) ) element_type( args... );
     return new( ptr ) Node;
   }
   
-  static void destroy_node_chain( Node* begin )
+  void destroy_slabs( )
   {
-    while( begin ) {
-      to_element( begin )->~element_type( );
-      Node* next = begin->next.load( std::memory_order_relaxed );
-      aligned_free( begin );
-      begin = next;
+    while( Slab* slab = slabs_ ) {
+      char* ptr = slab->begin( );
+      for( std::size_t i( 0 ); i < slab->count; ++i, ptr += stride_ )
+        to_element( reinterpret_cast< Node* >( ptr ) )->~element_type( );
+      slabs_ = slab->prev;
+      storages_.front( ).deallocate( slab, slab_size( slab->capacity ) );
+      storages_.pop_front( );
     }
   }
   
+  inline std::size_t slab_size( std::size_t capacity ) const
+  {
+    return sizeof( Slab ) + stride_ * capacity;
+  }
+  
   void push_node( Node* node ) 
   {
     assert( node->next.load( ) == nullptr );
@@ -95,8 +160,12 @@ private:
   }
 
 private:
-  Node*  tail_;
-  Node*  head_;
+  Node*         tail_;
+  Node*         head_;
+  Slab*         slabs_  = nullptr;  // the last allocated one
+  std::size_t   stride_ = 0;        // node with its element
+  
+  std::forward_list< storage_policy > storages_; // of the slabs, the last one first
 }; // class ScsrPool
 
 //--------------------------------------------------------------------------------
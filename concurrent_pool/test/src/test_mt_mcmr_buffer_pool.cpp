@@ -0,0 +1,189 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include "config.h"
+# include "thread_helper.h"
+//--------------------------------------------------------------------------------
+# include <scsp_ring_array.h>
+//--------------------------------------------------------------------------------
+# include "mcmr_buffer_pool.h"
+# include "scmr_buffer_pool.h"
+//--------------------------------------------------------------------------------
+# include <chrono>
+# include <cstdlib>
+# include <cstring>
+# include <set>
+# include <thread>
+# include <vector>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_mt_mcmr_buffer_pool )
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+namespace {
+//--------------------------------------------------------------------------------
+
+typedef concur::ScspRingArray< void* >  ring_type;      // allocator -> releaser
+typedef std::chrono::nanoseconds        nanosec_type;
+
+const unsigned    THREAD_COUNT  = 8;    // of allocators and of releasers
+const unsigned    RING_CAPACITY = 256;
+const std::size_t BUFFER_SIZE   = 256;
+
+inline nanosec_type now( ) {
+  return std::chrono::steady_clock::now( ).time_since_epoch( );
+}
+
+//--------------------------------------------------------------------------------
+
+template < unsigned CacheSize >
+struct McmrPoolWrap
+{
+  // enough to cover all caches and rings
+  void init( std::size_t count ) {
+    pool.init( count + 2 * THREAD_COUNT * CacheSize + THREAD_COUNT * RING_CAPACITY, BUFFER_SIZE );
+  }
+
+  inline void* pop( unsigned ) { return pool.pop( ); }
+  static inline void release( void* ptr ) { concpool::McmrBufferPool< CacheSize >::release( ptr ); }
+
+  // the threads are gone and their caches flushed
+  bool all_back( )
+  {
+    std::vector< void* > buffers;
+    while( void* buff = pool.pop( ) )
+      buffers.push_back( buff );
+    for( void* buff : buffers )
+      release( buff );
+    return buffers.size( ) == pool.capacity( );
+  }
+
+  concpool::McmrBufferPool< CacheSize > pool;
+};
+
+// a pool of its own for every allocator
+struct ScmrPoolWrap
+{
+  void init( std::size_t count ) {
+    for( concpool::ScmrBufferPool< >& pool : pools )
+      pool.init( count / THREAD_COUNT + RING_CAPACITY, BUFFER_SIZE );
+  }
+
+  inline void* pop( unsigned num ) { return pools[ num ].pop( ); }
+  static inline void release( void* ptr ) { concpool::ScmrBufferPool< >::release( ptr ); }
+  bool all_back( ) { return true; }
+
+  concpool::ScmrBufferPool< > pools[ THREAD_COUNT ];
+};
+
+struct MallocWrap
+{
+  void init( std::size_t ) { }
+
+  inline void* pop( unsigned ) { return std::malloc( BUFFER_SIZE ); }
+  static inline void release( void* ptr ) { std::free( ptr ); }
+  bool all_back( ) { return true; }
+};
+
+//--------------------------------------------------------------------------------
+
+// Allocator 'i' passes its buffers to releaser 'i', so with the Mcmr pool the
+// allocators live on buffers spilled by the releasers to the shared list. There
+// are more threads than cores on most boxes, so the waits yield.
+template < typename PoolType >
+void run( const char* title )
+{
+  const Config& cfg = get_config( );
+  const uint64_t per_thread_count = cfg.iteration_count;
+  const uint64_t total_count      = per_thread_count * THREAD_COUNT;
+
+  PoolType pool;
+  pool.init( static_cast< std::size_t >( cfg.pool_capacity ) );
+
+  ring_type* rings = new ring_type[ THREAD_COUNT ];
+  for( unsigned i( 0 ); i < THREAD_COUNT; ++i )
+    rings[ i ].init( RING_CAPACITY );
+
+  nanosec_type start_time;
+  { // run threads
+    ThreadHolder allocators;
+    allocators.initialize( THREAD_COUNT, [ & ]( unsigned num ){
+      for( uint64_t i( 0 ); i < per_thread_count; ++i ) {
+        void* buff = nullptr;
+        while( !( buff = pool.pop( num ) ) )
+          std::this_thread::yield( );
+        std::memset( buff, static_cast< int >( num ), 64 );
+
+        while( !rings[ num ].push( buff ) )
+          std::this_thread::yield( );
+      }
+    }, cfg.consumer_thread_affinity );
+
+    ThreadHolder releasers;
+    releasers.initialize( THREAD_COUNT, [ & ]( unsigned num ){
+      for( uint64_t i( 0 ); i < per_thread_count; ++i ) {
+        void* buff = nullptr;
+        while( !rings[ num ].pop( buff ) )
+          std::this_thread::yield( );
+        PoolType::release( buff );
+      }
+    }, cfg.releaser_thread_affinity );
+
+    start_time = now( );
+    allocators.launch( );
+    releasers.launch( );
+  }
+  const nanosec_type dur = now( ) - start_time;
+
+  delete[ ] rings;
+  BOOST_CHECK( pool.all_back( ) );
+  BOOST_TEST_MESSAGE( title << " (" << THREAD_COUNT << " allocators, " << THREAD_COUNT << " releasers): "
+                      << ( total_count ? double( dur.count( ) ) / total_count : 0.0 ) << " ns/buffer" );
+}
+
+//--------------------------------------------------------------------------------
+} // anonymous namespace
+//--------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( CASE_mcmr_buffer_pool )
+{
+  typedef concpool::McmrBufferPool< 4 > pool_type;
+
+  pool_type pool;
+  pool.init( 10, 32 );
+  BOOST_CHECK( pool.capacity( ) == 10 );
+
+  std::set< void* > buffers;
+  while( void* buff = pool.pop( ) ) {
+    std::memset( buff, 0, 32 );
+    buffers.insert( buff );
+  }
+  BOOST_REQUIRE( buffers.size( ) == 10 );
+
+  // released by another thread: the cache spills, the rest comes with its exit
+  std::thread releaser( [ & ]( ){
+    for( void* buff : buffers )
+      pool_type::release( buff );
+  } );
+  releaser.join( );
+
+  std::set< void* > again;
+  while( void* buff = pool.pop( ) )
+    again.insert( buff );
+  BOOST_CHECK( again == buffers );
+
+  for( void* buff : again )
+    pool_type::release( buff );
+} // CASE_mcmr_buffer_pool
+
+BOOST_AUTO_TEST_CASE( CASE_mt_mcmr_buffer_pool )
+{
+  run< McmrPoolWrap< 64 > >( "McmrBufferPool<64>" );
+  run< McmrPoolWrap< 16 > >( "McmrBufferPool<16>" );
+  run< ScmrPoolWrap >( "ScmrBufferPool per allocator" );
+  run< MallocWrap >( "malloc/free" );
+} // CASE_mt_mcmr_buffer_pool
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_mt_mcmr_buffer_pool
+//--------------------------------------------------------------------------------
@@ -8,7 +8,11 @@
 //--------------------------------------------------------------------------------
 # include <condvar_queue.h>
 //--------------------------------------------------------------------------------
+# include <algorithm>
+# include <atomic>
+# include <chrono>
 # include <thread>
+# include <vector>
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE( SUITE_scmp_pool_mt )
 //--------------------------------------------------------------------------------
@@ -26,11 +30,12 @@ typedef uint64_t item_type;
 
 //--------------------------------------------------------------------------------
 
-void run( )
+template < unsigned MagazineSize >
+void run( unsigned releaser_count )
 {
-  typedef concpool::ScmrPool< item_type >             pool_type;
-  typedef pool_type::holder_type                      holder_type;
-  typedef concur::CondvarQueue< holder_type >         queue_type;
+  typedef concpool::ScmrPool< item_type, MagazineSize, true >  pool_type;
+  typedef typename pool_type::holder_type                       holder_type;
+  typedef concur::CondvarQueue< holder_type >                   queue_type;
       
   Config cfg = get_config( );
   
@@ -40,8 +45,9 @@ void run( )
   // initialize the pool
   for( int64_t i( 0 ); i < cfg.pool_capacity; ++i )
     pool.create( 0 );
+  pool_type::flush( );
   
-  const uint64_t total_count  = cfg.iteration_count * cfg.releaser_thread_count;
+  const uint64_t total_count  = cfg.iteration_count * releaser_count;
   std::chrono::nanoseconds start_time;
   
   { // run threads
@@ -56,7 +62,7 @@ void run( )
     }, cfg.releaser_thread_affinity );
     
     ThreadHolder rthreads;
-    rthreads.initialize( cfg.releaser_thread_count, [ & ]( unsigned ){
+    rthreads.initialize( releaser_count, [ & ]( unsigned ){
       for( int64_t i( 0 ); i < cfg.iteration_count; ++i ) {
         holder_type holder;
         while( !queue.pop( holder, std::chrono::seconds( 1 ) ) ) ;
@@ -71,6 +77,10 @@ void run( )
   }
   std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ).time_since_epoch( ) - start_time;
   BOOST_TEST_MESSAGE( "duration: " << ( double( duration.count( ) ) / 1000000000.0 ) << "sec." );
+  BOOST_TEST_MESSAGE( "magazine " << MagazineSize << ", " << releaser_count << " releasers: "
+                      << ( double( duration.count( ) ) / total_count ) << " ns/element; "
+                      << ( pool.releases( ) ? double( pool.exchanges( ) ) / pool.releases( ) : 0.0 )
+                      << " exchanges per release" );
   
   { // check pool state
     uint64_t  elements_count  = 0;
@@ -88,12 +98,96 @@ void run( )
   }
 }
 
+// No hand-off: in every round the consumer pops the whole pool and deals the
+// holders out to the releasers, then only the releasing is timed, so the time
+// is the cost of the pushes and exchanges on 'head_' alone.
+template < unsigned MagazineSize >
+void run_direct( unsigned releaser_count )
+{
+  typedef concpool::ScmrPool< item_type, MagazineSize, true >  pool_type;
+  typedef typename pool_type::holder_type                       holder_type;
+  
+  const Config cfg = get_config( );
+  
+  const uint64_t capacity     = static_cast< uint64_t >( cfg.pool_capacity );
+  const uint64_t total_count  = cfg.iteration_count * releaser_count;
+  const uint64_t round_count  = ( std::max )( total_count / capacity, uint64_t( 1 ) );
+  
+  pool_type pool;
+  pool.init( capacity, 0 );
+  
+  std::vector< std::vector< holder_type > > batches( releaser_count );
+  std::atomic< uint64_t > round( 0 );
+  std::atomic< unsigned > done( 0 );
+  std::chrono::nanoseconds duration( 0 );
+  uint64_t released = 0;
+  const uint64_t releases   = pool.releases( );
+  const uint64_t exchanges  = pool.exchanges( );
+  
+  { // run threads
+    ThreadHolder rthreads;
+    rthreads.initialize( releaser_count, [ & ]( unsigned num ){
+      for( uint64_t r( 1 ); r <= round_count; ++r ) {
+        while( round.load( std::memory_order_acquire ) != r )
+          std::this_thread::yield( );
+        batches[ num ].clear( );
+        pool_type::flush( );
+        done.fetch_add( 1, std::memory_order_acq_rel );
+      }
+    }, cfg.releaser_thread_affinity );
+    rthreads.launch( );
+    
+    for( uint64_t r( 1 ); r <= round_count; ++r ) {
+      unsigned rnum = 0;
+      while( holder_type holder = pool.pop( ) ) {
+        batches[ rnum++ % releaser_count ].push_back( std::move( holder ) );
+        ++released;
+      }
+      
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+      round.store( r, std::memory_order_release );
+      while( done.load( std::memory_order_acquire ) != r * releaser_count )
+        std::this_thread::yield( );
+      duration += std::chrono::steady_clock::now( ) - start;
+    }
+  }
+  
+  BOOST_CHECK( released == round_count * capacity );
+  BOOST_CHECK( pool.releases( ) - releases == released );
+  BOOST_TEST_MESSAGE( "direct, magazine " << MagazineSize << ", " << releaser_count << " releasers: "
+                      << ( released ? double( duration.count( ) ) / released : 0.0 ) << " ns/release; "
+                      << ( released ? double( pool.exchanges( ) - exchanges ) / released : 0.0 )
+                      << " exchanges per release" );
+}
+
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE( CASE_pool_cycle )
 {
-  run( );
+  run< 0 >( get_config( ).releaser_thread_count );
 } // CASE_pool_cycle
 //--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_pool_magazine )
+{
+  const int64_t capacity = get_config( ).pool_capacity;
+  
+  for( unsigned releaser_count( 1 ); releaser_count <= 16; releaser_count *= 2 ) {
+    run< 0 >( releaser_count );
+    // parked nodes must leave something for the consumer
+    if( capacity > releaser_count * 7 )
+      run< 8 >( releaser_count );
+    if( capacity > releaser_count * 31 )
+      run< 32 >( releaser_count );
+  }
+  
+  for( unsigned releaser_count( 1 ); releaser_count <= 16; releaser_count *= 2 ) {
+    run_direct< 0 >( releaser_count );
+    run_direct< 8 >( releaser_count );
+    run_direct< 32 >( releaser_count );
+  }
+} // CASE_pool_magazine
+//--------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmp_pool_mt
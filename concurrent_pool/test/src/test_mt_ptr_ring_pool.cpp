@@ -1 +1,184 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include "config.h"
+# include "thread_helper.h"
+//--------------------------------------------------------------------------------
 # include "mt_ptr_ring_pool.h"
+//--------------------------------------------------------------------------------
+# include <algorithm>
+# include <atomic>
+# include <chrono>
+# include <mutex>
+# include <vector>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_mt_ptr_ring_pool )
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+namespace {
+//--------------------------------------------------------------------------------
+
+struct Item
+{
+  std::atomic< bool >   taken{ false };
+  uint64_t              usage = 0;
+};
+
+// the former implementation, with take( ) and release( ) under one mutex
+template < typename Type >
+class MutexPtrRingPool
+{
+public:
+  typedef Type      element_type;
+  typedef Type*     pointer_type;
+
+  ~MutexPtrRingPool( )
+  {
+    for( unsigned i( 0 ); i < size_; ++i )
+      delete ring_[ i ];
+    delete[ ] ring_;
+  }
+
+  void alloc( unsigned size )
+  {
+    ring_ = new pointer_type[ size ]( );
+    size_ = size;
+  }
+
+  inline pointer_type take( )
+  {
+    pointer_type val = nullptr;
+    {
+      lock_type lk( mtx_ );
+      std::swap( val, ring_[ tail_ % size_ ] );
+      if( val ) ++tail_;
+    }
+    return val;
+  }
+
+  inline void release( pointer_type ptr )
+  {
+    lock_type lk( mtx_ );
+    ring_[ head_++ % size_ ] = ptr;
+  }
+
+private:
+  typedef std::lock_guard< std::mutex > lock_type;
+
+  std::mutex      mtx_;
+  pointer_type*   ring_ = nullptr;
+  unsigned        size_ = 0;
+  unsigned        head_ = 0;
+  unsigned        tail_ = 0;
+};
+
+//--------------------------------------------------------------------------------
+
+// Every thread takes an element, checks nobody else holds it and gives it back.
+template < typename PoolType >
+void run( const char* title, unsigned thread_count )
+{
+  const Config& cfg = get_config( );
+  const unsigned size = static_cast< unsigned >( cfg.pool_capacity );
+
+  PoolType pool;
+  pool.alloc( size );
+  for( unsigned i( 0 ); i < size; ++i )
+    pool.release( new Item );
+
+  std::atomic< uint64_t > misses{ 0 };
+  std::atomic< bool >     shared{ true };
+  const auto start_time = std::chrono::steady_clock::now( );
+  {
+    ThreadHolder threads;
+    threads.initialize( thread_count, [ & ]( unsigned ){
+      uint64_t miss_count = 0;
+      for( int64_t i( 0 ); i < cfg.iteration_count; ++i ) {
+        Item* item = nullptr;
+        while( !( item = pool.take( ) ) )
+          ++miss_count;
+
+        if( item->taken.exchange( true, std::memory_order_acquire ) )
+          shared.store( false, std::memory_order_relaxed );
+        ++item->usage;
+        item->taken.store( false, std::memory_order_release );
+
+        pool.release( item );
+      }
+      misses.fetch_add( miss_count, std::memory_order_relaxed );
+    }, cfg.releaser_thread_affinity );
+    threads.launch( );
+  }
+  const std::chrono::nanoseconds duration = std::chrono::steady_clock::now( ) - start_time;
+
+  BOOST_CHECK( shared.load( ) );
+
+  { // every element is back and used as many times as taken
+    std::vector< Item* > items;
+    uint64_t usage_count = 0;
+    while( Item* item = pool.take( ) ) {
+      items.push_back( item );
+      usage_count += item->usage;
+    }
+    BOOST_CHECK( items.size( ) == size );
+    BOOST_CHECK( usage_count == uint64_t( cfg.iteration_count ) * thread_count );
+    for( Item* item : items )
+      pool.release( item );
+  }
+
+  const uint64_t total_count = uint64_t( cfg.iteration_count ) * thread_count;
+  BOOST_TEST_MESSAGE( title << " (" << thread_count << " threads): "
+                      << ( total_count ? double( duration.count( ) ) / total_count : 0.0 ) << " ns/cycle; "
+                      << misses.load( ) << " empty takes" );
+}
+
+//--------------------------------------------------------------------------------
+} // anonymous namespace
+//--------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( CASE_ptr_ring_pool )
+{
+  concpool::PtrRingPool< Item > pool;
+  pool.alloc( 3 );
+  BOOST_CHECK( pool.take( ) == nullptr );
+
+  Item* a = new Item;
+  Item* b = new Item;
+  pool.release( a );
+  pool.release( b );
+  BOOST_CHECK( pool.take( ) == a );
+
+  // wraps around the ring
+  pool.release( a );
+  BOOST_CHECK( pool.take( ) == b );
+  BOOST_CHECK( pool.take( ) == a );
+  BOOST_CHECK( pool.take( ) == nullptr );
+
+  pool.release( a );
+  pool.release( b ); // the pool deletes what is left in it
+
+  // a full pool refuses more
+  Item* c = new Item;
+  Item* d = new Item;
+  BOOST_CHECK( pool.release( c ) );
+  BOOST_CHECK( !pool.release( d ) );
+  BOOST_CHECK( pool.over_releases( ) == 1 );
+  delete d;
+} // CASE_ptr_ring_pool
+
+BOOST_AUTO_TEST_CASE( CASE_mt_ptr_ring_pool )
+{
+  // 1, 2, 4 ... threads up to the releaser thread count
+  const unsigned max_count = ( std::max )( get_config( ).releaser_thread_count, 1u );
+  for( unsigned count( 1 ); ; count = ( std::min )( count * 2, max_count ) ) {
+    run< concpool::PtrRingPool< Item > >( "PtrRingPool", count );
+    run< MutexPtrRingPool< Item > >( "mutex PtrRingPool", count );
+    if( count == max_count )
+      break;
+  }
+} // CASE_mt_ptr_ring_pool
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_mt_ptr_ring_pool
+//--------------------------------------------------------------------------------
@@ -8,55 +8,109 @@
 //--------------------------------------------------------------------------------
 # include <scmp_ring_array.h>
 //--------------------------------------------------------------------------------
+# include <algorithm>
+# include <chrono>
 # include <thread>
+# include <vector>
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE( SUITE_mt_scmr_octopus_pool )
 //--------------------------------------------------------------------------------
 
 typedef uint64_t item_type;
 
+const unsigned POP_N_MAX = 32;
+
+// how the consumer spreads elements over releasers (lanes)
+enum class Skew
+{
+  uniform,  // round robin
+  hot_lane, // 90% to lane 0, the rest round robin over the others
+  one_lane  // all to lane 0
+};
+
+const char* skew_name( Skew skew )
+{
+  switch( skew ) {
+  case Skew::uniform:   return "uniform";
+  case Skew::hot_lane:  return "hot lane";
+  case Skew::one_lane:  return "one lane";
+  }
+  return "";
+}
+
+unsigned lane_for( Skew skew, uint64_t i, unsigned rcount )
+{
+  switch( skew ) {
+  case Skew::uniform:   return i % rcount;
+  case Skew::hot_lane:  return ( rcount == 1 || i % 10 ) ? 0 : 1 + ( i / 10 ) % ( rcount - 1 );
+  case Skew::one_lane:  return 0;
+  }
+  return 0;
+}
+
 //--------------------------------------------------------------------------------
 
-void run( )
+// The consumer pops elements ('pop' or 'pop_n') and passes them to releasers
+// according to 'skew', releasers return them to their lanes.
+// Reports consumer ns/pop (including empty probes) and the empty pop ratio.
+void run( Skew skew = Skew::uniform, bool bulk = false )
 {
   typedef concpool::ScmrOctopusPool< item_type >    pool_type;
   typedef concur::ScmpRingArray< item_type*, 64 >   ring_type;
       
   const Config& cfg = get_config( );
+  const unsigned rcount = cfg.releaser_thread_count;
   
   pool_type pool;
-  pool.init( cfg.releaser_thread_count, cfg.pool_capacity, sizeof( item_type ), 0 );
+  pool.init( rcount, cfg.pool_capacity, sizeof( item_type ), 0 );
   
-  ring_type* rings = new ring_type[ cfg.releaser_thread_count ];
-  for( unsigned i( 0 ); i < cfg.releaser_thread_count; ++i )
+  concur::utils::aligned_array< ring_type > rings = concur::utils::make_aligned_array< ring_type >( rcount );
+  for( unsigned i( 0 ); i < rcount; ++i )
     rings[ i ].init( cfg.pool_capacity );
   
-  const uint64_t total_count = cfg.iteration_count * cfg.releaser_thread_count;
+  const uint64_t total_count = cfg.iteration_count * rcount;
+  std::vector< int64_t > release_counts( rcount, 0 );
+  for( uint64_t i( 0 ); i < total_count; ++i )
+    ++release_counts[ lane_for( skew, i, rcount ) ];
+  
   bool consumer_check = true;
   bool releaser_check = true;
+  uint64_t empty_pops = 0;
+  std::chrono::nanoseconds consumer_time( 0 );
   
   { // run threads
     ThreadHolder consumer;
     consumer.initialize( 1, [ & ]( unsigned ){
-      for( uint64_t i( 0 ); i < total_count; ++i ) {
-        const unsigned rnum = i % cfg.releaser_thread_count;
-        
-        item_type* it = nullptr;
-        while( !( it = pool.pop( ) ) )
-          ;
+      const auto start_time = std::chrono::steady_clock::now( );
+      
+      item_type* items[ POP_N_MAX ];
+      for( uint64_t i( 0 ); i < total_count; ) {
+        const unsigned max = static_cast< unsigned >(
+              ( std::min )( static_cast< uint64_t >( bulk ? POP_N_MAX : 1 ), total_count - i ) );
         
-        consumer_check &= ( *it == 0 );
-        *it = rnum;
+        unsigned count = 0;
+        while( !( count = bulk ? pool.pop_n( items, max ) : ( ( items[ 0 ] = pool.pop( ) ) != nullptr ) ) )
+          ++empty_pops;
         
-        while( !rings[ rnum ].push( it ) )
-          ;
+        for( unsigned k( 0 ); k < count; ++k, ++i ) {
+          item_type* it = items[ k ];
+          const unsigned rnum = lane_for( skew, i, rcount );
+          
+          consumer_check &= ( *it == 0 );
+          *it = rnum;
+          
+          while( !rings[ rnum ].push( it ) )
+            ;
+        }
       }
+      
+      consumer_time = std::chrono::steady_clock::now( ) - start_time;
     }, cfg.consumer_thread_affinity );
     
     ThreadHolder releasers;
-    releasers.initialize( cfg.releaser_thread_count, [ & ]( unsigned rnum ){
+    releasers.initialize( rcount, [ & ]( unsigned rnum ){
       ring_type& ring = rings[ rnum ];
-      for( int64_t i( 0 ); i < cfg.iteration_count; ++i ) {
+      for( int64_t i( 0 ); i < release_counts[ rnum ]; ++i ) {
         item_type* it = nullptr;
         while( !( ring.pop( it ) ) )
           ;
@@ -75,14 +129,16 @@ void run( )
   {
     // all rings must be empty
     item_type* it = nullptr;
-    for( unsigned i( 0 ); i < cfg.releaser_thread_count; ++i ) 
+    for( unsigned i( 0 ); i < rcount; ++i ) 
       BOOST_REQUIRE( !rings[ i ].pop( it ) );
-    
-    delete[ ] rings;
   }
   
   BOOST_CHECK( consumer_check );
   BOOST_CHECK( releaser_check );
+  BOOST_TEST_MESSAGE( skew_name( skew ) << ", " << ( bulk ? "pop_n" : "pop" )
+                      << " (" << rcount << " releasers): "
+                      << ( total_count ? double( consumer_time.count( ) ) / total_count : 0.0 ) << " ns/pop; "
+                      << ( total_count ? double( empty_pops ) / total_count : 0.0 ) << " empty pops per element" );
 }
 
 //--------------------------------------------------------------------------------
@@ -91,7 +147,38 @@ BOOST_AUTO_TEST_CASE( CASE_scmr_octopus_pool )
   run( );
 } // CASE_scmr_octopus_pool
 //--------------------------------------------------------------------------------
-
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmr_octopus_pool_pop_n )
+{
+  concpool::ScmrOctopusPool< item_type > pool;
+  pool.init( 2, 8, sizeof( item_type ), 0 );
+  
+  item_type* items[ 8 ];
+  BOOST_CHECK( pool.pop_n( items, 8 ) == 3 ); // one node stays in every lane
+  BOOST_CHECK( pool.pop_n( items + 3, 8 ) == 3 );
+  BOOST_CHECK( pool.pop_n( items, 8 ) == 0 );
+  BOOST_CHECK( pool.pop( ) == nullptr );
+  
+  for( unsigned i( 0 ); i < 6; ++i )
+    pool.release( 1, items[ i ] );
+  BOOST_CHECK( pool.pop_n( items, 4 ) == 4 );
+  BOOST_CHECK( pool.pop_n( items + 4, 4 ) == 2 );
+  
+  for( unsigned i( 0 ); i < 6; ++i )
+    pool.release( i % 2, items[ i ] );
+} // CASE_scmr_octopus_pool_pop_n
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmr_octopus_pool_skew )
+{
+  const Skew skews[ ] = { Skew::uniform, Skew::hot_lane, Skew::one_lane };
+  for( Skew skew : skews ) {
+    run( skew, false );
+    run( skew, true );
+  }
+} // CASE_scmr_octopus_pool_skew
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END( ) // SUITE_mt_scmr_octopus_pool
 //--------------------------------------------------------------------------------
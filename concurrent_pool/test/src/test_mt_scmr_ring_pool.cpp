@@ -5,10 +5,13 @@
 # include "thread_helper.h"
 //--------------------------------------------------------------------------------
 # include <scmr_ring_pool.h>
+# include <scmr_elastic_ring_pool.h>
 //--------------------------------------------------------------------------------
 # include <scmp_ring_array.h>
 //--------------------------------------------------------------------------------
+# include <algorithm>
 # include <thread>
+# include <vector>
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE( SUITE_mt_scmr_ring_pool )
 //--------------------------------------------------------------------------------
@@ -17,9 +20,10 @@ typedef uint64_t item_type;
 
 //--------------------------------------------------------------------------------
 
+template < typename StoragePolicy >
 void run( )
 {
-  typedef concpool::ScmrRingPool< item_type >   pool_type;
+  typedef concpool::ScmrRingPool< item_type, 64, concur::utils::modulo_index, StoragePolicy >   pool_type;
   typedef concur::ScmpRingArray< item_type*, 64 >   ring_type;
       
   const Config& cfg = get_config( );
@@ -100,9 +104,152 @@ void run( )
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE( CASE_scmr_ring_pool )
 {
-  run( );
+  run< concur::utils::heap_storage >( );
 } // CASE_scmr_ring_pool
 //--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmr_ring_pool_mapped )
+{
+  run< concur::utils::mapped_storage< true > >( );
+} // CASE_scmr_ring_pool_mapped
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scmr_elastic_ring_pool )
+{
+  typedef concpool::ScmrElasticRingPool< item_type > pool_type;
+  
+  pool_type::config_type pool_cfg;
+  pool_cfg.segment_size   = 4;
+  pool_cfg.grow_after     = 2;
+  pool_cfg.max_capacity   = 12;
+  pool_cfg.high_watermark = 8;
+  pool_cfg.low_watermark  = 4;
+  pool_cfg.shrink_period  = 2;
+  
+  pool_type pool;
+  pool.configure( pool_cfg );
+  pool.init( 4, sizeof( item_type ), 7 );
+  BOOST_CHECK( pool.capacity( ) == 4 );
+  
+  std::vector< item_type* > holder;
+  for( unsigned i( 0 ); i < 4; ++i )
+    holder.push_back( pool.pop( ) );
+  
+  BOOST_CHECK( pool.pop( ) == nullptr ); // the first failure doesn't grow
+  holder.push_back( pool.pop( ) );
+  BOOST_REQUIRE( holder.back( ) != nullptr );
+  BOOST_CHECK( pool.capacity( ) == 8 && pool.grows( ) == 1 );
+  
+  for( unsigned i( 0 ); i < 16; ++i ) {
+    if( item_type* it = pool.pop( ) )
+      holder.push_back( it );
+  }
+  BOOST_CHECK( holder.size( ) == 12 ); // limited with max_capacity
+  BOOST_CHECK( pool.capacity( ) == 12 && pool.grows( ) == 2 );
+  
+  for( item_type* it : holder ) {
+    BOOST_CHECK( *it == 7 );
+    pool_type::release( it );
+  }
+  holder.clear( );
+  
+  // idle elements stay above the high watermark: the last segment goes away
+  for( unsigned i( 0 ); i < 8; ++i ) {
+    item_type* it = pool.pop( );
+    BOOST_REQUIRE( it );
+    pool_type::release( it );
+  }
+  BOOST_CHECK( pool.shrinks( ) >= 1 );
+  BOOST_CHECK( pool.capacity( ) + 4 * pool.shrinks( ) == 12 );
+  BOOST_CHECK( pool.capacity( ) >= 8 ); // low watermark is kept
+} // CASE_scmr_elastic_ring_pool
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_mt_scmr_elastic_ring_pool )
+{
+  typedef concpool::ScmrElasticRingPool< item_type >  pool_type;
+  typedef concur::ScmpRingArray< item_type*, 64 >     ring_type;
+  
+  const Config& cfg = get_config( );
+  const uint64_t total_count = cfg.iteration_count * cfg.releaser_thread_count;
+  
+  // the pool starts small, the consumer keeps up to 'burst' elements out during
+  // the first half and a few elements later, so the pool grows and shrinks back
+  const std::size_t base = 16;
+  const std::size_t burst = static_cast< std::size_t >( cfg.pool_capacity );
+  
+  pool_type::config_type pool_cfg;
+  pool_cfg.segment_size   = 64;
+  pool_cfg.grow_after     = 256;
+  pool_cfg.high_watermark = 128;
+  pool_cfg.low_watermark  = 64;
+  pool_cfg.shrink_period  = 256;
+  pool_cfg.max_capacity   = 2 * burst + base;
+  
+  pool_type pool;
+  pool.configure( pool_cfg );
+  pool.init( base, sizeof( item_type ), 0 );
+  
+  concur::utils::aligned_array< ring_type > rings = concur::utils::make_aligned_array< ring_type >( cfg.releaser_thread_count );
+  for( unsigned i( 0 ); i < cfg.releaser_thread_count; ++i )
+    rings[ i ].init( static_cast< unsigned >( pool_cfg.max_capacity ) );
+  
+  std::size_t peak_capacity = 0;
+  std::atomic< uint64_t > released( 0 );
+  
+  { // run threads
+    ThreadHolder consumer;
+    consumer.initialize( 1, [ & ]( unsigned ){
+      std::vector< item_type* > held;
+      held.reserve( burst );
+      unsigned rnum = 0;
+      
+      for( uint64_t i( 0 ); i < total_count; ++i ) {
+        item_type* it = nullptr;
+        while( !( it = pool.pop( ) ) )
+          ;
+        held.push_back( it );
+        
+        const std::size_t keep = ( i < total_count / 2 ) ? burst : 1;
+        if( held.size( ) >= keep || i + 1 == total_count ) {
+          for( item_type* h : held ) {
+            ring_type& ring = rings[ rnum++ % cfg.releaser_thread_count ];
+            while( !ring.push( h ) )
+              ;
+          }
+          held.clear( );
+        }
+        peak_capacity = ( std::max )( peak_capacity, pool.capacity( ) );
+      }
+    }, cfg.consumer_thread_affinity );
+    
+    ThreadHolder releasers;
+    releasers.initialize( cfg.releaser_thread_count, [ & ]( unsigned i ){
+      ring_type& ring = rings[ i ];
+      while( released.load( ) < total_count ) {
+        item_type* it = nullptr;
+        if( ring.pop( it ) ) {
+          ++( *it );
+          pool_type::release( it );
+          released.fetch_add( 1 );
+        }
+      }
+    }, cfg.releaser_thread_affinity );
+    
+    consumer.launch( );
+    releasers.launch( );
+  }
+  
+  BOOST_CHECK( released.load( ) == total_count );
+  BOOST_CHECK( pool.grows( ) > 0 );
+  BOOST_TEST_MESSAGE( "elastic ring pool: base " << base << ", peak capacity " << peak_capacity
+                      << ", final capacity " << pool.capacity( )
+                      << "; grows " << pool.grows( ) << ", shrinks " << pool.shrinks( ) );
+} // CASE_mt_scmr_elastic_ring_pool
+//--------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END( ) // SUITE_mt_scmr_ring_pool
@@ -7,7 +7,9 @@
 # include <scsr_pool.h>
 # include <scsp_ring_array.h>
 //--------------------------------------------------------------------------------
+# include <chrono>
 # include <thread>
+# include <vector>
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE( SUITE_mt_scsr_pool )
 //--------------------------------------------------------------------------------
@@ -16,10 +18,11 @@ typedef uint64_t item_type;
 
 //--------------------------------------------------------------------------------
 
+template < typename StoragePolicy >
 void run( )
 {
-  typedef concpool::ScsrPool< item_type >           pool_type;
-  typedef concur::ScspRingArray< item_type*, 64 >   ring_type;
+  typedef concpool::ScsrPool< item_type, 64, StoragePolicy >  pool_type;
+  typedef concur::ScspRingArray< item_type*, 64 >             ring_type;
       
   const Config& cfg = get_config( );
   
@@ -78,12 +81,77 @@ void run( )
   }
 }
 
+
+// Init and destruction time of a pool against an aligned_malloc per node, the
+// way the pool used to allocate its nodes.
+void run_init( std::size_t count )
+{
+  typedef concpool::ScsrPool< item_type >   pool_type;
+  typedef std::chrono::steady_clock         clock_type;
+  typedef std::chrono::microseconds         usec_type;
+  
+  clock_type::time_point start = clock_type::now( );
+  usec_type init_time, free_time;
+  {
+    pool_type pool;
+    pool.init( count, sizeof( item_type ), 0 );
+    init_time = std::chrono::duration_cast< usec_type >( clock_type::now( ) - start );
+    
+    // every node must be there
+    std::size_t popped = 0;
+    while( item_type* it = pool.pop( ) ) {
+      BOOST_REQUIRE( *it == 0 );
+      ++popped;
+    }
+    BOOST_CHECK( popped == count - 1 ); // one node stays in the pool
+    start = clock_type::now( );
+  }
+  free_time = std::chrono::duration_cast< usec_type >( clock_type::now( ) - start );
+  
+  usec_type node_init_time, node_free_time;
+  {
+    std::vector< void* > nodes( count );
+    start = clock_type::now( );
+    for( void*& ptr : nodes ) {
+      ptr = aligned_malloc( 64, 64 + sizeof( item_type ) );
+      BOOST_REQUIRE( ptr );
+      new( static_cast< char* >( ptr ) + 64 ) item_type( 0 );
+    }
+    node_init_time = std::chrono::duration_cast< usec_type >( clock_type::now( ) - start );
+    
+    start = clock_type::now( );
+    for( void* ptr : nodes )
+      aligned_free( ptr );
+    node_free_time = std::chrono::duration_cast< usec_type >( clock_type::now( ) - start );
+  }
+  
+  BOOST_TEST_MESSAGE( count << " elements: slabs init " << init_time.count( ) << " us, free "
+                      << free_time.count( ) << " us; node per malloc init " << node_init_time.count( )
+                      << " us, free " << node_free_time.count( ) << " us" );
+}
+
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE( CASE_scsr_pool )
 {
-  run( );
+  run< concur::utils::heap_storage >( );
 } // CASE_scsr_pool
 //--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsr_pool_mapped )
+{
+  run< concur::utils::mapped_storage< true > >( );
+} // CASE_scsr_pool_mapped
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_scsr_pool_init )
+{
+  run_init( 10000 );
+  run_init( 1000000 );
+  run_init( 10000000 );
+} // CASE_scsr_pool_init
+//--------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END( ) // SUITE_mt_scsr_pool
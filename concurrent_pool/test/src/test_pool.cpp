@@ -9,6 +9,7 @@
 # include <condvar_queue.h>
 //--------------------------------------------------------------------------------
 # include <thread>
+# include <vector>
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE( SUITE_scmp_pool )
 //--------------------------------------------------------------------------------
@@ -34,6 +35,78 @@ BOOST_AUTO_TEST_CASE( CASE_pool_cycle )
   }
 } // CASE_pool_cycle
 //--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_pool_magazine )
+{
+  typedef concpool::ScmrPool< item_type, 4 >    mag_pool_type;
+  
+  mag_pool_type pool;
+  pool.init( 8, 1 );
+  
+  { // three releases stay in the magazine, the fourth pushes it
+    std::vector< mag_pool_type::holder_type > holders;
+    while( mag_pool_type::holder_type holder = pool.pop( ) )
+      holders.push_back( std::move( holder ) );
+    BOOST_CHECK( holders.size( ) == 8 );
+    
+    holders.resize( 5 );
+    BOOST_CHECK( !pool.pop( ) && pool.exchanges( ) == 0 );
+    holders.resize( 4 );
+    BOOST_CHECK( pool.exchanges( ) == 1 && pool.releases( ) == 4 );
+    
+    holders.clear( );
+    mag_pool_type::flush( );
+    BOOST_CHECK( pool.exchanges( ) == 2 && pool.releases( ) == 8 );
+  }
+  
+  std::vector< mag_pool_type::holder_type > holders;
+  while( mag_pool_type::holder_type holder = pool.pop( ) ) {
+    BOOST_CHECK( *holder == 1 );
+    holders.push_back( std::move( holder ) );
+  }
+  BOOST_CHECK( holders.size( ) == 8 );
+} // CASE_pool_magazine
+//--------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( CASE_pool_release_all )
+{
+  typedef concpool::ScmrPool< item_type, 0, true >  stats_pool_type;
+  typedef stats_pool_type::holder_type              stats_holder_type;
+  
+  stats_pool_type pool;
+  pool.init( 6, 7 );
+  
+  std::vector< stats_holder_type > holders;
+  while( stats_holder_type holder = pool.pop( ) )
+    holders.push_back( std::move( holder ) );
+  BOOST_REQUIRE( holders.size( ) == 6 );
+  holders.emplace_back( );  // empty holders are skipped
+  
+  pool.release_all( holders.begin( ), holders.end( ) );
+  BOOST_CHECK( pool.exchanges( ) == 1 && pool.releases( ) == 6 );
+  for( const stats_holder_type& holder : holders )
+    BOOST_CHECK( !holder );
+  
+  holders.clear( );
+  while( stats_holder_type holder = pool.pop( ) ) {
+    BOOST_CHECK( *holder == 7 );
+    holders.push_back( std::move( holder ) );
+  }
+  BOOST_CHECK( holders.size( ) == 6 );
+  
+  // without a magazine every single release is an exchange
+  holders.clear( );
+  BOOST_CHECK( pool.exchanges( ) == 7 && pool.releases( ) == 12 );
+  
+  // the default pool without a magazine doesn't count
+  pool_type plain;
+  plain.init( 1, 0 );
+  plain.pop( );
+  BOOST_CHECK( plain.exchanges( ) == 0 && plain.releases( ) == 0 );
+} // CASE_pool_release_all
+//--------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmp_pool
@@ -11,6 +11,8 @@
 # include "scmr_octopus_pool.h"
 # include <scmp_ring_array.h>
 //--------------------------------------------------------------------------------
+# include <vector>
+//--------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE( SUITE_scmr_buffer_pool )
 //--------------------------------------------------------------------------------
 
@@ -152,12 +154,97 @@ struct ScmrBufferPoolWrap
   }
   
 private:
-  concpool::ScmrBufferPool pool;
+  concpool::ScmrBufferPool< > pool;
+};
+
+// releasers return buffers in batches of 'BatchSize'
+template < unsigned BatchSize >
+struct ScmrBufferPoolBatchWrap
+{
+  ~ScmrBufferPoolBatchWrap( )
+  {
+    for( std::vector< void* >& batch : batches )
+      concpool::ScmrBufferPool< >::release_all( batch.begin( ), batch.end( ) );
+  }
+  
+  inline void init( unsigned rcount, std::size_t count, std::size_t buffer_size ) {
+    pool.init( count, buffer_size );
+    batches.resize( rcount );
+    for( std::vector< void* >& batch : batches )
+      batch.reserve( BatchSize );
+  }
+  
+  inline void release( unsigned rnum, void* buff ) {
+    std::vector< void* >& batch = batches[ rnum ];
+    batch.push_back( buff );
+    if( batch.size( ) == BatchSize ) {
+      concpool::ScmrBufferPool< >::release_all( batch.begin( ), batch.end( ) );
+      batch.clear( );
+    }
+  }
+  
+  inline void* pop( ) {
+    return pool.pop( );
+  }
+  
+private:
+  concpool::ScmrBufferPool< >           pool;
+  std::vector< std::vector< void* > >   batches;
 };
 
 BOOST_AUTO_TEST_CASE( CASE_scmr_buffer_pool )
 {
   run< ScmrBufferPoolWrap >( "ScmrBufferPool" );
+  
+  // buffers held in batches must leave some for the producer
+  const Config& cfg = get_config( );
+  if( cfg.pool_capacity > cfg.releaser_thread_count * 16 )
+    run< ScmrBufferPoolBatchWrap< 16 > >( "ScmrBufferPool, release_all( 16 )" );
+  if( cfg.pool_capacity > cfg.releaser_thread_count * 64 )
+    run< ScmrBufferPoolBatchWrap< 64 > >( "ScmrBufferPool, release_all( 64 )" );
+}
+
+BOOST_AUTO_TEST_CASE( CASE_scmr_buffer_pool_release_all )
+{
+  // buffers go back to their pools whatever backs them
+  concpool::ScmrBufferPool< >                                             pool_a;
+  concpool::ScmrBufferPool< concur::utils::mapped_storage< false > >     pool_b;
+  pool_a.init( 4, 16 );
+  pool_b.init( 4, 16 );
+  
+  std::vector< void* > buffers;
+  for( unsigned i( 0 ); i < 4; ++i ) {
+    buffers.push_back( pool_a.pop( ) );
+    buffers.push_back( pool_b.pop( ) );
+  }
+  BOOST_REQUIRE( !pool_a.pop( ) && !pool_b.pop( ) );
+  
+  // runs of different pools
+  concpool::ScmrBufferPool< >::release_all( buffers.begin( ), buffers.begin( ) + 4 );
+  
+  // a chain linked by hand
+  concpool::ScmrBufferPool< >::link( buffers[ 4 ], buffers[ 6 ] );
+  concpool::ScmrBufferPool< >::release_chain( buffers[ 4 ], buffers[ 6 ] );
+  concpool::ScmrBufferPool< >::link( buffers[ 5 ], buffers[ 7 ] );
+  concpool::ScmrBufferPool< >::release_chain( buffers[ 5 ], buffers[ 7 ] );
+  
+  // all buffers are back in their pools
+  buffers.clear( );
+  unsigned count_a = 0, count_b = 0;
+  for( unsigned i( 0 ); i < 8; ++i ) {
+    if( void* buff = pool_a.pop( ) ) {
+      buffers.push_back( buff );
+      ++count_a;
+    }
+    if( void* buff = pool_b.pop( ) ) {
+      buffers.push_back( buff );
+      ++count_b;
+    }
+  }
+  BOOST_CHECK( count_a == 4 && count_b == 4 );
+  
+  for( void* buff : buffers )
+    concpool::ScmrBufferPool< >::release( buff );
 }
 
 //--------------------------------------------------------------------------------
@@ -0,0 +1,189 @@
+//--------------------------------------------------------------------------------
+# include <boost/test/auto_unit_test.hpp>
+# include <boost/test/test_tools.hpp>
+# include "config.h"
+# include "thread_helper.h"
+//--------------------------------------------------------------------------------
+# include <scsp_ring_array.h>
+//--------------------------------------------------------------------------------
+# include "scmr_sized_buffer_pool.h"
+//--------------------------------------------------------------------------------
+# include <chrono>
+# include <cstdlib>
+# include <cstring>
+# include <vector>
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SUITE_scmr_sized_buffer_pool )
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+namespace {
+//--------------------------------------------------------------------------------
+
+typedef concur::ScspRingArray< void* >  ring_type;      // producer -> releaser
+typedef std::chrono::nanoseconds        nanosec_type;
+
+inline nanosec_type now( ) {
+  return std::chrono::steady_clock::now( ).time_since_epoch( );
+}
+
+// Message sizes: 50% up to 64B, 20% up to 256B, 15% up to 1KB, 10% up to 4KB
+// and 5% up to 64KB.
+std::vector< std::size_t > make_sizes( std::size_t count )
+{
+  struct { unsigned percent; std::size_t min; std::size_t max; } const BANDS[ ] = {
+    { 50, 1, 64 }, { 20, 65, 256 }, { 15, 257, 1024 }, { 10, 1025, 4096 }, { 5, 4097, 65536 }
+  };
+
+  std::vector< std::size_t > sizes;
+  sizes.reserve( count );
+  uint64_t seed = 12345;
+  for( std::size_t i( 0 ); i < count; ++i ) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    unsigned percent = static_cast< unsigned >( ( seed >> 33 ) % 100 );
+    for( const auto& band : BANDS ) {
+      if( percent < band.percent ) {
+        sizes.push_back( band.min + ( seed >> 13 ) % ( band.max - band.min + 1 ) );
+        break;
+      }
+      percent -= band.percent;
+    }
+  }
+  return sizes;
+}
+
+//--------------------------------------------------------------------------------
+
+struct SizedPoolWrap
+{
+  void init( std::size_t count )
+  {
+    pool.init( {
+      { 64, count }, { 256, count }, { 1024, count }, { 4096, count / 2 + 1 }, { 65536, count / 8 + 1 }
+    } );
+  }
+
+  inline void* pop( std::size_t size ) { return pool.pop( size ); }
+  static inline void release( void* ptr ) { concpool::ScmrSizedBufferPool::release( ptr ); }
+
+  bool all_back( ) const
+  {
+    for( std::size_t i( 0 ); i < pool.class_count( ); ++i ) {
+      if( pool.in_use( i ) )
+        return false;
+    }
+    return true;
+  }
+
+  concpool::ScmrSizedBufferPool pool;
+};
+
+struct MallocWrap
+{
+  void init( std::size_t ) { }
+
+  inline void* pop( std::size_t size ) { return std::malloc( size ); }
+  static inline void release( void* ptr ) { std::free( ptr ); }
+
+  bool all_back( ) const { return true; }
+};
+
+//--------------------------------------------------------------------------------
+
+// The producer takes buffers of the replayed sizes, touches them and passes
+// them to releasers, which give them back.
+template < typename PoolType >
+void run( const char* title )
+{
+  const Config& cfg = get_config( );
+
+  const unsigned releaser_count = cfg.releaser_thread_count;
+  const uint64_t total_count    = cfg.iteration_count * releaser_count;
+  const std::vector< std::size_t > sizes = make_sizes( 4096 );
+
+  PoolType pool;
+  pool.init( static_cast< std::size_t >( cfg.pool_capacity ) );
+
+  ring_type* rings = new ring_type[ releaser_count ];
+  for( unsigned i( 0 ); i < releaser_count; ++i )
+    rings[ i ].init( static_cast< unsigned >( cfg.pool_capacity ) );
+
+  nanosec_type start_time;
+  { // run threads
+    ThreadHolder producer;
+    producer.initialize( 1, [ & ]( unsigned ){
+      for( uint64_t i( 0 ); i < total_count; ++i ) {
+        const std::size_t size = sizes[ i % sizes.size( ) ];
+        void* buff = nullptr;
+        while( !( buff = pool.pop( size ) ) )
+          ;
+        std::memset( buff, 0, ( std::min )( size, std::size_t( 64 ) ) );
+
+        ring_type& ring = rings[ i % releaser_count ];
+        while( !ring.push( buff ) )
+          ;
+      }
+    }, cfg.consumer_thread_affinity );
+
+    ThreadHolder releasers;
+    releasers.initialize( releaser_count, [ & ]( unsigned num ){
+      for( int64_t i( 0 ); i < cfg.iteration_count; ++i ) {
+        void* buff = nullptr;
+        while( !rings[ num ].pop( buff ) )
+          ;
+        PoolType::release( buff );
+      }
+    }, cfg.releaser_thread_affinity );
+
+    start_time = now( );
+    producer.launch( );
+    releasers.launch( );
+  }
+  const nanosec_type dur = now( ) - start_time;
+
+  delete[ ] rings;
+  BOOST_CHECK( pool.all_back( ) );
+  BOOST_TEST_MESSAGE( title << " (" << releaser_count << " releasers): "
+                      << ( total_count ? double( dur.count( ) ) / total_count : 0.0 ) << " ns/buffer" );
+}
+
+//--------------------------------------------------------------------------------
+} // anonymous namespace
+//--------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( CASE_sized_buffer_pool_classes )
+{
+  concpool::ScmrSizedBufferPool pool;
+  pool.init_pow2( 64, 1024, 2 );
+
+  BOOST_REQUIRE( pool.class_count( ) == 5 );
+  BOOST_CHECK( pool.payload_size( 0 ) == 64 && pool.payload_size( 4 ) == 1024 );
+
+  void* a = pool.pop( 1 );
+  void* b = pool.pop( 64 );
+  void* c = pool.pop( 65 );   // 128
+  void* d = pool.pop( 64 );   // 64 is empty: falls through to 128
+  BOOST_CHECK( a && b && c && d );
+  BOOST_CHECK( pool.in_use( 0 ) == 2 && pool.in_use( 1 ) == 2 );
+  BOOST_CHECK( pool.pop( 2000 ) == nullptr );
+
+  std::memset( d, 1, 128 );
+  concpool::ScmrSizedBufferPool::release( a );
+  concpool::ScmrSizedBufferPool::release( d );
+  BOOST_CHECK( pool.in_use( 0 ) == 1 && pool.in_use( 1 ) == 1 );
+
+  concpool::ScmrSizedBufferPool::release( b );
+  concpool::ScmrSizedBufferPool::release( c );
+  for( std::size_t i( 0 ); i < pool.class_count( ); ++i )
+    BOOST_CHECK( pool.in_use( i ) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( CASE_sized_buffer_pool_vs_malloc )
+{
+  run< SizedPoolWrap >( "ScmrSizedBufferPool" );
+  run< MallocWrap >( "malloc/free" );
+}
+
+//--------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE_END( ) // SUITE_scmr_sized_buffer_pool
+//--------------------------------------------------------------------------------